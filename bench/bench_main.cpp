@@ -0,0 +1,285 @@
+#include "../src/model.hpp"
+#include "../src/input_parser.hpp"
+#include "../src/engine.hpp"
+#include "../src/csv_writer.hpp"
+#include "../src/simulation.hpp"
+#include "../src/portfolio.hpp"
+#include "../src/score.hpp"
+#include "../src/validate.hpp"
+#include "../src/presolve.hpp"
+#include "../src/anneal.hpp"
+#include "roster_gen.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <malloc.h>
+#include <sys/resource.h>
+
+// Heap tracking (live and peak bytes) through the global allocation functions
+
+static std::atomic<size_t> g_live_bytes{0};
+static std::atomic<size_t> g_peak_bytes{0};
+
+static void* tracked_alloc(size_t n) {
+    void* p = std::malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    size_t live = g_live_bytes.fetch_add(malloc_usable_size(p)) + malloc_usable_size(p);
+    size_t peak = g_peak_bytes.load();
+    while (live > peak && !g_peak_bytes.compare_exchange_weak(peak, live)) {}
+    return p;
+}
+
+static void tracked_free(void* p) {
+    if (!p) return;
+    g_live_bytes.fetch_sub(malloc_usable_size(p));
+    std::free(p);
+}
+
+void* operator new(size_t n) { return tracked_alloc(n); }
+void* operator new[](size_t n) { return tracked_alloc(n); }
+void operator delete(void* p) noexcept { tracked_free(p); }
+void operator delete[](void* p) noexcept { tracked_free(p); }
+void operator delete(void* p, size_t) noexcept { tracked_free(p); }
+void operator delete[](void* p, size_t) noexcept { tracked_free(p); }
+
+// Discards everything written to it (CSV writer benchmarks measure formatting only)
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+// Harness
+
+struct BenchConfig {
+    int min_scale = 100;
+    int max_scale = 10000;
+    double min_time = 0.5; // seconds per benchmark
+    std::string filter;
+};
+
+// Runs `fn` repeatedly for at least min_time and prints one result row
+static void run_bench(const BenchConfig& cfg, const std::string& name, size_t items,
+                      const std::function<void()>& fn) {
+    if (!cfg.filter.empty() && name.find(cfg.filter) == std::string::npos) return;
+
+    using clock = std::chrono::steady_clock;
+    size_t base_bytes = g_live_bytes.load();
+    g_peak_bytes.store(base_bytes);
+
+    size_t iterations = 0;
+    double elapsed = 0.0;
+    size_t batch = 1;
+    while (elapsed < cfg.min_time) {
+        auto t0 = clock::now();
+        for (size_t i = 0; i < batch; ++i) fn();
+        elapsed += std::chrono::duration<double>(clock::now() - t0).count();
+        iterations += batch;
+        // Grow the batch towards the remaining time, like Google Benchmark
+        double per_iter = elapsed / static_cast<double>(iterations);
+        double remaining = cfg.min_time - elapsed;
+        batch = per_iter > 0 ? static_cast<size_t>(remaining / per_iter) + 1 : batch * 10;
+        if (batch > 1000000) batch = 1000000;
+    }
+
+    double per_iter_ms = elapsed * 1e3 / static_cast<double>(iterations);
+    double items_per_sec = static_cast<double>(items) * static_cast<double>(iterations) / elapsed;
+    double peak_mib = static_cast<double>(g_peak_bytes.load() - base_bytes) / (1024.0 * 1024.0);
+
+    std::cout << std::left << std::setw(34) << name << std::right
+              << std::setw(14) << std::fixed << std::setprecision(3) << per_iter_ms
+              << std::setw(12) << iterations
+              << std::setw(16) << std::setprecision(0) << items_per_sec
+              << std::setw(14) << std::setprecision(2) << peak_mib << "\n";
+}
+
+static void print_usage() {
+    std::cout << "Usage:\n"
+              << "  bench_runner [--min-scale N] [--max-scale N] [--min-time SECONDS] [--filter SUBSTR]\n"
+              << "  bench_runner --emit-roster SCALE FILE.json\n"
+              << "\nScales run in powers of ten (number of shifts in the synthetic roster).\n\n";
+}
+
+int main(int argc, char** argv) {
+    BenchConfig cfg;
+
+    // Parse flags
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--min-scale" && i + 1 < argc) {
+            cfg.min_scale = std::atoi(argv[++i]);
+        } else if (arg == "--max-scale" && i + 1 < argc) {
+            cfg.max_scale = std::atoi(argv[++i]);
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            cfg.min_time = std::atof(argv[++i]);
+        } else if (arg == "--filter" && i + 1 < argc) {
+            cfg.filter = argv[++i];
+        } else if (arg == "--emit-roster" && i + 2 < argc) {
+            // Write a reference roster instead of benchmarking
+            int scale = std::atoi(argv[++i]);
+            std::ofstream out(argv[++i]);
+            if (!out) {
+                std::cerr << "Error: Cannot open file for writing: " << argv[i] << "\n";
+                return 2;
+            }
+            out << generate_roster_json(roster_spec_for_scale(scale));
+            return 0;
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << "\n";
+            print_usage();
+            return 1;
+        }
+    }
+
+    std::cout << std::left << std::setw(34) << "Benchmark" << std::right
+              << std::setw(14) << "Time(ms)"
+              << std::setw(12) << "Iterations"
+              << std::setw(16) << "Items/s"
+              << std::setw(14) << "PeakHeap(MiB)" << "\n"
+              << std::string(90, '-') << "\n";
+
+    NullBuffer null_buf;
+    std::ostream null_out(&null_buf);
+
+    for (int scale = cfg.min_scale; scale <= cfg.max_scale; scale *= 10) {
+        RosterSpec spec = roster_spec_for_scale(scale);
+        std::string json_text = generate_roster_json(spec);
+        InputModel model = parse_input_json(json_text);
+        ScheduleResult result = build_schedule(model);
+        std::string suffix = "/" + std::to_string(scale);
+
+        run_bench(cfg, "parse_input_json" + suffix, model.shifts.size(), [&] {
+            InputModel m = parse_input_json(json_text);
+            if (m.shifts.empty()) std::abort();
+        });
+
+        run_bench(cfg, "build_schedule" + suffix, model.shifts.size(), [&] {
+            ScheduleResult r = build_schedule(model);
+            if (r.shift_count() == 0) std::abort();
+        });
+
+        PenaltyTable penalties = build_penalty_table(model);
+        EngineOptions shared;
+        shared.penalties = &penalties;
+        run_bench(cfg, "build_schedule_shared_penalties" + suffix, model.shifts.size(), [&] {
+            ScheduleResult r = build_schedule(model, shared);
+            if (r.shift_count() == 0) std::abort();
+        });
+
+        run_bench(cfg, "score_schedule" + suffix, model.shifts.size(), [&] {
+            ScheduleScore s = score_schedule(model, result);
+            if (s.required_slots == 0) std::abort();
+        });
+
+        // Audit of the finished schedule on one thread, as if read back from CSV
+        run_bench(cfg, "validate_schedule" + suffix, result.staff_index.size(), [&] {
+            ValidationReport r = validate_schedule(model, result, 1);
+            if (!r.violations.empty()) std::abort();
+        });
+
+        run_bench(cfg, "presolve" + suffix, model.shifts.size(), [&] {
+            PresolveReport r = presolve(model);
+            if (r.required_slots == 0) std::abort();
+        });
+
+        EngineOptions scarcity;
+        scarcity.shift_order = ShiftOrder::Scarcity;
+        run_bench(cfg, "build_schedule_scarcity" + suffix, model.shifts.size(), [&] {
+            ScheduleResult r = build_schedule(model, scarcity);
+            if (r.shift_count() == 0) std::abort();
+        });
+
+        // Greedy plus branch and bound on every role within the exact-mode limits
+        EngineOptions exact;
+        exact.exact.enabled = true;
+        run_bench(cfg, "build_schedule_exact" + suffix, model.shifts.size(), [&] {
+            ScheduleResult r = build_schedule(model, exact);
+            if (r.shift_count() == 0) std::abort();
+        });
+
+        // Annealing moves on the greedy schedule: Items/s is moves per second
+        AnnealOptions anneal;
+        anneal.max_moves = 100000;
+        run_bench(cfg, "anneal_moves" + suffix, anneal.max_moves, [&] {
+            AnnealOutcome r = anneal_assignments(model, result, penalties, anneal);
+            if (r.stats.moves != anneal.max_moves) std::abort();
+        });
+
+        // Each specialized loop against the runtime-branching loop on the same options
+        for (int variant = 0; variant < 4; ++variant) {
+            EngineOptions opt;
+            opt.fairness_on = (variant & 1) == 0;
+            opt.respect_preferences = (variant & 2) == 0;
+            std::string combo = std::string(opt.fairness_on ? "fair" : "nofair") + "_" +
+                                (opt.respect_preferences ? "pref" : "nopref");
+            for (bool runtime : {false, true}) {
+                opt.runtime_dispatch = runtime;
+                run_bench(cfg, "engine_" + combo + (runtime ? "_runtime" : "_static") + suffix, model.shifts.size(), [&] {
+                    ScheduleResult r = build_schedule(model, opt);
+                    if (r.shift_count() == 0) std::abort();
+                });
+            }
+        }
+
+        // Eight passes on one thread: the cost of the portfolio itself, without parallel speedup
+        PortfolioOptions portfolio;
+        portfolio.passes = 8;
+        portfolio.threads = 1;
+        run_bench(cfg, "run_portfolio_x8" + suffix, model.shifts.size(), [&] {
+            PortfolioResult r = run_portfolio(model, portfolio);
+            if (r.best.shift_count() == 0) std::abort();
+        });
+
+        // Single thread so the number tracks per-sample cost, not core count
+        SimulationOptions sim;
+        sim.samples = 100;
+        sim.threads = 1;
+        run_bench(cfg, "simulate_callouts_x100" + suffix, sim.samples, [&] {
+            SimulationReport r = simulate_callouts(model, result, sim);
+            if (r.samples != sim.samples) std::abort();
+        });
+
+        run_bench(cfg, "write_schedule_csv" + suffix, model.shifts.size(), [&] {
+            write_schedule_csv(model, result, null_out);
+        });
+
+        run_bench(cfg, "write_staff_summary_csv" + suffix, model.staff.size(), [&] {
+            write_staff_summary_csv(model, result, null_out);
+        });
+
+        run_bench(cfg, "write_warnings_csv" + suffix, result.warnings.size(), [&] {
+            write_warnings_csv(result, null_out);
+        });
+    }
+
+    // Annealing on a 2,000-staff roster (8,000 shifts), between the 1000 and 10000 scales
+    const int anneal_scale = 8000;
+    if (cfg.min_scale <= anneal_scale && anneal_scale <= cfg.max_scale) {
+        InputModel model = parse_input_json(generate_roster_json(roster_spec_for_scale(anneal_scale)));
+        ScheduleResult result = build_schedule(model);
+        PenaltyTable penalties = build_penalty_table(model);
+        AnnealOptions anneal;
+        anneal.max_moves = 100000;
+        run_bench(cfg, "anneal_moves/" + std::to_string(model.staff.size()) + "_staff", anneal.max_moves, [&] {
+            AnnealOutcome r = anneal_assignments(model, result, penalties, anneal);
+            if (r.stats.moves != anneal.max_moves) std::abort();
+        });
+    }
+
+    struct rusage ru {};
+    getrusage(RUSAGE_SELF, &ru);
+    std::cout << std::string(90, '-') << "\n"
+              << "Process max RSS: " << std::setprecision(1)
+              << static_cast<double>(ru.ru_maxrss) / 1024.0 << " MiB\n";
+
+    return 0;
+}
@@ -0,0 +1,43 @@
+#!/bin/sh
+# Times scheduler build variants on reference rosters.
+# Usage: compare_builds.sh "ROSTER.json ..." RUNS BASELINE_BINARY [OTHER_BINARY ...]
+# Prints the best wall time of RUNS runs per (roster, binary) and the speedup over the baseline.
+
+rosters=$1
+runs=$2
+shift 2
+
+if [ -z "$rosters" ] || [ -z "$runs" ] || [ $# -lt 1 ]; then
+    echo "Usage: $0 \"ROSTER.json ...\" RUNS BASELINE_BINARY [OTHER_BINARY ...]" >&2
+    exit 1
+fi
+
+out_dir=$(mktemp -d)
+trap 'rm -rf "$out_dir"' EXIT
+
+# Best wall time in milliseconds of $runs runs of binary $1 on roster $2
+best_ms() {
+    best=""
+    i=0
+    while [ $i -lt "$runs" ]; do
+        t0=$(date +%s%N)
+        "$1" "$2" --csv "$out_dir/out.csv" > /dev/null || return 1
+        t1=$(date +%s%N)
+        ms=$(( (t1 - t0) / 1000000 ))
+        if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then best=$ms; fi
+        i=$((i + 1))
+    done
+    echo "$best"
+}
+
+printf "%-32s %-28s %12s %10s\n" "Roster" "Binary" "Best(ms)" "Speedup"
+printf "%s\n" "----------------------------------------------------------------------------------"
+for roster in $rosters; do
+    base=""
+    for bin in "$@"; do
+        ms=$(best_ms "$bin" "$roster") || { echo "Error: $bin failed on $roster" >&2; exit 2; }
+        [ -z "$base" ] && base=$ms
+        speedup=$(awk -v b="$base" -v m="$ms" 'BEGIN { if (m > 0) printf "%.2fx", b / m; else print "-" }')
+        printf "%-32s %-28s %12s %10s\n" "$(basename "$roster")" "$bin" "$ms" "$speedup"
+    done
+done
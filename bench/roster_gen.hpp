@@ -0,0 +1,155 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Deterministic synthetic hospital roster for benchmarks.
+// Same spec + seed gives the same JSON on every platform (own RNG, no <random> distributions).
+
+struct RosterSpec {
+    int staff = 100;
+    int units = 4;
+    int roles = 3;            // RN, LPN, CNA, RT, MD (first N used)
+    int days = 28;            // horizon length
+    int shifts_per_day = 3;   // per unit and role: day, evening, night
+    double availability_density = 0.85; // chance a staff member can work a given day
+    double avoid_nights_ratio = 0.3;    // staff with avoid_nights
+    double preferred_unit_ratio = 0.5;  // staff with one or two preferred units
+    int max_required_count = 3;         // shifts need 1..max staff
+    std::uint64_t seed = 42;
+};
+
+// Spec with roughly `shifts` shifts and a staff pool sized to cover most of them
+inline RosterSpec roster_spec_for_scale(int shifts) {
+    RosterSpec spec;
+    int per_day = spec.roles * spec.shifts_per_day;
+    spec.days = shifts / per_day;
+    if (spec.days > 28) spec.days = 28;
+    if (spec.days < 1) spec.days = 1;
+    spec.units = shifts / (per_day * spec.days);
+    if (spec.units < 1) spec.units = 1;
+    spec.staff = shifts / 4;
+    if (spec.staff < 10) spec.staff = 10;
+    return spec;
+}
+
+namespace roster_gen_detail {
+
+// splitmix64: tiny, fast and identical everywhere
+struct Rng {
+    std::uint64_t state;
+    std::uint64_t next() {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    double uniform() { return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0); }
+    int below(int n) { return static_cast<int>(next() % static_cast<std::uint64_t>(n)); }
+};
+
+inline bool is_leap(int y) { return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0; }
+
+inline int days_in_month(int y, int m) {
+    static const int dim[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return (m == 2 && is_leap(y)) ? 29 : dim[m - 1];
+}
+
+// "YYYY-MM-DD" for 2025-04-07 (a Monday) plus `offset` days
+inline std::string date_str(int offset) {
+    int y = 2025, m = 4, d = 7 + offset;
+    while (d > days_in_month(y, m)) {
+        d -= days_in_month(y, m);
+        if (++m > 12) { m = 1; ++y; }
+    }
+    char buf[48];
+    std::snprintf(buf, sizeof(buf), "%04d-%02d-%02d", y, m, d);
+    return buf;
+}
+
+inline std::string padded(const char* prefix, int n, int width) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%s%0*d", prefix, width, n);
+    return buf;
+}
+
+} // namespace roster_gen_detail
+
+inline std::string generate_roster_json(const RosterSpec& spec) {
+    using namespace roster_gen_detail;
+    static const char* role_names[] = {"RN", "LPN", "CNA", "RT", "MD"};
+    // start hour, length in hours (night wraps to the next day)
+    static const int slot_start[] = {7, 15, 23};
+    static const int slot_len[] = {8, 8, 8};
+
+    Rng rng{spec.seed};
+    int roles = spec.roles < 1 ? 1 : (spec.roles > 5 ? 5 : spec.roles);
+
+    std::string out;
+    out.reserve(static_cast<size_t>(spec.staff) * 256 +
+                static_cast<size_t>(spec.units) * roles * spec.days * spec.shifts_per_day * 128);
+
+    out += "{\n  \"rules\": {\"max_hours_per_week_default\": 40, \"max_consecutive_days_default\": 5, "
+           "\"min_rest_hours_default\": 12, \"hard_constraints\": [\"coverage\", \"legal_limits\"], "
+           "\"soft_constraints\": [\"preferences\", \"fairness\"]},\n";
+
+    // Staff
+    out += "  \"staff\": [\n";
+    for (int i = 0; i < spec.staff; ++i) {
+        std::string id = padded("S", i, 6);
+        out += "    {\"id\": \"" + id + "\", \"name\": \"Staff " + std::to_string(i) + "\", ";
+        out += "\"role\": \"" + std::string(role_names[rng.below(roles)]) + "\"";
+        if (rng.uniform() < 0.2) out += ", \"max_weekly_hours\": " + std::to_string(rng.below(2) ? 24 : 32);
+
+        bool avoid = rng.uniform() < spec.avoid_nights_ratio;
+        bool pref = rng.uniform() < spec.preferred_unit_ratio;
+        if (avoid || pref) {
+            out += ", \"preferences\": {\"avoid_nights\": ";
+            out += avoid ? "true" : "false";
+            if (pref) {
+                out += ", \"preferred_unit\": [\"" + padded("U", rng.below(spec.units), 4) + "\"";
+                if (rng.below(2)) out += ", \"" + padded("U", rng.below(spec.units), 4) + "\"";
+                out += "]";
+            }
+            out += "}";
+        }
+
+        out += ", \"availability\": [";
+        bool first = true;
+        for (int d = 0; d < spec.days; ++d) {
+            if (rng.uniform() < spec.availability_density) continue;
+            out += first ? "" : ", ";
+            out += "{\"date\": \"" + date_str(d) + "\", \"can_work\": false}";
+            first = false;
+        }
+        out += "]}";
+        out += (i + 1 < spec.staff) ? ",\n" : "\n";
+    }
+    out += "  ],\n";
+
+    // Shifts
+    out += "  \"shifts\": [\n";
+    int n = 0;
+    int total = spec.units * roles * spec.days * spec.shifts_per_day;
+    for (int d = 0; d < spec.days; ++d) {
+        for (int s = 0; s < spec.shifts_per_day; ++s) {
+            int slot = s % 3;
+            int end_hour = slot_start[slot] + slot_len[slot];
+            std::string start = date_str(d) + "T" + padded("", slot_start[slot], 2) + ":00";
+            std::string end = date_str(d + end_hour / 24) + "T" + padded("", end_hour % 24, 2) + ":00";
+            for (int u = 0; u < spec.units; ++u) {
+                for (int r = 0; r < roles; ++r) {
+                    out += "    {\"id\": \"" + padded("SH", n, 7) + "\", \"name\": \"" + padded("U", u, 4) + "\", ";
+                    out += "\"start\": \"" + start + "\", \"end\": \"" + end + "\", ";
+                    out += "\"req_role\": \"" + std::string(role_names[r]) + "\", ";
+                    out += "\"required_count\": " + std::to_string(1 + rng.below(spec.max_required_count)) + "}";
+                    ++n;
+                    out += (n < total) ? ",\n" : "\n";
+                }
+            }
+        }
+    }
+    out += "  ]\n}\n";
+
+    return out;
+}
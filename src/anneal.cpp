@@ -0,0 +1,372 @@
+#include "anneal.hpp"
+#include "constraints.hpp"
+#include "eligibility.hpp"
+#include "rng.hpp"
+#include "score.hpp"
+#include "timeline.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+
+namespace {
+
+using Minute = std::int32_t;
+constexpr std::uint32_t kEmpty = UINT32_MAX;
+constexpr std::uint32_t kNoRole = EligibilityKernel::kNoRole;
+
+// Shift as the annealer sees it (minutes since the first shift start)
+struct AnnealShift {
+    Minute start;
+    Minute end;
+    std::int32_t day;          // the eligibility kernel's day
+    std::uint32_t role;        // interned; kNoRole if no staff has it
+    std::uint32_t unit;        // penalty table column
+    bool night;
+    std::uint32_t first_slot;  // slots first_slot .. first_slot + slots
+    std::uint32_t slots;
+    Minute duration() const { return end - start; }
+};
+
+class Annealer {
+public:
+    Annealer(const InputModel& model, const ScheduleResult& schedule, const PenaltyTable& penalties,
+             const AnnealOptions& opt)
+        : model_(model), penalties_(penalties), opt_(opt), weights_(selected_weights(model.rules, opt.weights.value_or(model.rules.objective))),
+          rng_(opt.seed), kernel_(model, schedule.shift_index, select_constraints(model.rules).hard) {
+        hard_ = kernel_.hard();
+        n_days_ = kernel_.day_count();
+        const size_t n_staff = model.staff.size();
+        const size_t n_shifts = schedule.shift_count();
+
+        members_.resize(kernel_.role_count());
+        for (std::uint32_t w = 0; w < n_staff; ++w) members_[kernel_.staff_role(w)].push_back(w);
+
+        // Shifts and their slots (as many as required, or as staffed if more)
+        shifts_.resize(n_shifts);
+        const SysTime horizon = model.shifts[schedule.shift_index[0]].start;
+        std::uint32_t slot_total = 0;
+        for (size_t k = 0; k < n_shifts; ++k) {
+            const Shifts& sh = model.shifts[schedule.shift_index[k]];
+            const auto slots = static_cast<std::uint32_t>(
+                std::max<long>(sh.required_count, static_cast<long>(schedule.staff_count(k))));
+            shifts_[k] = AnnealShift{
+                static_cast<Minute>(std::chrono::duration_cast<std::chrono::minutes>(sh.start - horizon).count()),
+                static_cast<Minute>(std::chrono::duration_cast<std::chrono::minutes>(sh.end - horizon).count()),
+                kernel_.shift_day(k),
+                kernel_.shift_role(k),
+                penalties.column_of(sh.name),
+                sh.is_night(),
+                slot_total,
+                slots};
+            slot_total += slots;
+        }
+        slot_staff_.assign(slot_total, kEmpty);
+        slot_shift_.resize(slot_total);
+        role_slots_.resize(kernel_.role_count());
+        for (std::uint32_t k = 0; k < n_shifts; ++k) {
+            const AnnealShift& sh = shifts_[k];
+            for (std::uint32_t s = sh.first_slot; s < sh.first_slot + sh.slots; ++s) {
+                slot_shift_[s] = k;
+                if (sh.role != kNoRole) role_slots_[sh.role].push_back(s);
+            }
+        }
+        for (std::uint32_t r = 0; r < role_slots_.size(); ++r) {
+            if (!members_[r].empty()) movable_.insert(movable_.end(), role_slots_[r].begin(), role_slots_[r].end());
+        }
+
+        // The schedule as the starting state
+        minutes_.assign(n_staff, 0);
+        nights_.assign(n_staff, 0);
+        if (hard_ & constraint::rest) timelines_.reset(n_staff, slot_total);
+        if (hard_ & constraint::consecutive_days) day_count_.assign(n_staff * static_cast<size_t>(n_days_), 0);
+        for (auto& sh : shifts_) open_ += sh.slots;
+        for (std::uint32_t k = 0; k < n_shifts; ++k) {
+            std::uint32_t s = shifts_[k].first_slot;
+            for (const std::uint32_t* p = schedule.staff_begin(k); p != schedule.staff_end(k); ++p, ++s) {
+                slot_staff_[s] = *p;
+                add(*p, k);
+            }
+        }
+        // Slots beyond the requirement are not open ones
+        for (const auto& sh : shifts_) {
+            const Shifts& src = model.shifts[schedule.shift_index[&sh - shifts_.data()]];
+            open_ -= sh.slots - static_cast<std::uint32_t>(std::max<int>(src.required_count, 0));
+        }
+    }
+
+    AnnealOutcome run() {
+        AnnealOutcome out;
+        using clock = std::chrono::steady_clock;
+        const auto t0 = clock::now();
+        const double initial = score();
+        out.stats.initial_score = initial;
+
+        if (!movable_.empty()) {
+            // Start hot enough to take a typical worsening move, end a thousand times colder
+            double worse_sum = 0;
+            int worse = 0;
+            for (int i = 0; i < 256; ++i) {
+                const double delta = propose(-1.0);
+                if (delta > 0) {
+                    worse_sum += delta;
+                    ++worse;
+                }
+            }
+            const double t_start = worse > 0 ? worse_sum / worse : 1.0;
+            double temperature = t_start;
+
+            const std::vector<std::uint32_t> initial_slots = slot_staff_;
+            std::vector<std::uint32_t> best_slots = slot_staff_;
+            double best = initial;
+            std::uint64_t last_snapshot = 0;
+            const double budget = opt_.time_budget_ms / 1e3;
+            while (opt_.max_moves == 0 || moves_ < opt_.max_moves) {
+                if ((moves_ & 255) == 0) {
+                    double progress = 0;
+                    if (budget > 0) progress = std::chrono::duration<double>(clock::now() - t0).count() / budget;
+                    if (opt_.max_moves > 0) {
+                        progress = std::max(progress, static_cast<double>(moves_) / static_cast<double>(opt_.max_moves));
+                    }
+                    if (progress >= 1.0) break;
+                    temperature = t_start * std::pow(1e-3, progress);
+                    // Keep the best state seen, copied at most every 4096 moves
+                    const double now = score();
+                    if (now < best && moves_ - last_snapshot >= 4096) {
+                        best = now;
+                        best_slots = slot_staff_;
+                        last_snapshot = moves_;
+                    }
+                }
+                ++moves_;
+                propose(temperature);
+                accepted_ += last_accepted_;
+            }
+            if (score() < best) {
+                best = score();
+                best_slots = slot_staff_;
+            }
+            if (best < initial) {
+                out.improved = best_slots != initial_slots;
+                slot_staff_ = std::move(best_slots);
+                out.stats.final_score = best;
+            } else {
+                slot_staff_ = initial_slots;
+                out.stats.final_score = initial;
+            }
+        } else {
+            out.stats.final_score = initial;
+        }
+
+        out.staff_offsets.reserve(shifts_.size() + 1);
+        out.staff_offsets.push_back(0);
+        for (const auto& sh : shifts_) {
+            for (std::uint32_t s = sh.first_slot; s < sh.first_slot + sh.slots; ++s) {
+                if (slot_staff_[s] != kEmpty) out.staff_index.push_back(slot_staff_[s]);
+            }
+            out.staff_offsets.push_back(static_cast<std::uint32_t>(out.staff_index.size()));
+        }
+        out.stats.moves = moves_;
+        out.stats.accepted = accepted_;
+        out.stats.seconds = std::chrono::duration<double>(clock::now() - t0).count();
+        return out;
+    }
+
+private:
+    // Weighted objective of the current state, as score_schedule (score.hpp) computes it
+    double score() const {
+        const double n = static_cast<double>(minutes_.size());
+        double variance = 0, night_variance = 0;
+        if (n > 0) {
+            const double mean = static_cast<double>(sum_) / n;
+            variance = std::max(0.0, static_cast<double>(sum_sq_) / n - mean * mean) / 3600.0;
+            const double mean_nights = static_cast<double>(night_sum_) / n;
+            night_variance = std::max(0.0, static_cast<double>(night_sum_sq_) / n - mean_nights * mean_nights);
+        }
+        return weights_.shortfall * static_cast<double>(open_) + weights_.hours_variance * variance +
+               weights_.preference * static_cast<double>(violations_) + weights_.night_variance * night_variance;
+    }
+
+    bool on_shift(std::uint32_t w, std::uint32_t k) const {
+        const AnnealShift& sh = shifts_[k];
+        for (std::uint32_t s = sh.first_slot; s < sh.first_slot + sh.slots; ++s) {
+            if (slot_staff_[s] == w) return true;
+        }
+        return false;
+    }
+
+    bool worked(std::uint32_t w, std::int32_t d) const {
+        return day_count_[w * static_cast<size_t>(n_days_) + static_cast<size_t>(d)] > 0;
+    }
+
+    // Every hard constraint for w taking shift k (w not on it yet), as the engine checks them
+    bool can_add(std::uint32_t w, std::uint32_t k) const {
+        const AnnealShift& sh = shifts_[k];
+        if (!kernel_.role_ok(w, k) || !kernel_.available(w, sh.day)) return false;
+        if (!kernel_.hours_ok(w, minutes_[w], k)) return false;
+        if ((hard_ & constraint::rest) && !timelines_.fits(w, sh.start, sh.end, Minute{model_.staff[w].min_rest} * 60)) return false;
+        if ((hard_ & constraint::consecutive_days) &&
+            !kernel_.consecutive_ok_with([&](std::int32_t d) { return worked(w, d); }, w, k)) return false;
+        if (!kernel_.skills_ok(w, k)) return false;
+        return !on_shift(w, k);
+    }
+
+    // Bookkeeping for w taking or leaving shift k (the slot itself is set by the caller)
+    void add(std::uint32_t w, std::uint32_t k) {
+        const AnnealShift& sh = shifts_[k];
+        const std::int64_t m = minutes_[w];
+        minutes_[w] += sh.duration();
+        sum_ += sh.duration();
+        sum_sq_ += std::int64_t{minutes_[w]} * minutes_[w] - m * m;
+        violations_ += penalties_.penalty(w, sh.unit, sh.night) > 0;
+        if (sh.night) {
+            night_sum_ += 1;
+            night_sum_sq_ += 2 * std::int64_t{nights_[w]} + 1;
+            ++nights_[w];
+        }
+        --open_;
+        if (hard_ & constraint::rest) timelines_.insert(w, sh.start, sh.end);
+        if (hard_ & constraint::consecutive_days) ++day_count_[w * static_cast<size_t>(n_days_) + static_cast<size_t>(sh.day)];
+    }
+
+    void remove(std::uint32_t w, std::uint32_t k) {
+        const AnnealShift& sh = shifts_[k];
+        const std::int64_t m = minutes_[w];
+        minutes_[w] -= sh.duration();
+        sum_ -= sh.duration();
+        sum_sq_ += std::int64_t{minutes_[w]} * minutes_[w] - m * m;
+        violations_ -= penalties_.penalty(w, sh.unit, sh.night) > 0;
+        if (sh.night) {
+            --nights_[w];
+            night_sum_ -= 1;
+            night_sum_sq_ -= 2 * std::int64_t{nights_[w]} + 1;
+        }
+        ++open_;
+        if (hard_ & constraint::rest) timelines_.erase(w, sh.start);
+        if (hard_ & constraint::consecutive_days) --day_count_[w * static_cast<size_t>(n_days_) + static_cast<size_t>(sh.day)];
+    }
+
+    // Move worker `in` into slot s in place of its occupant (either may be kEmpty);
+    // false, with nothing changed, if `in` cannot take the shift
+    bool place(std::uint32_t s, std::uint32_t in) {
+        const std::uint32_t k = slot_shift_[s];
+        const std::uint32_t out = slot_staff_[s];
+        if (out != kEmpty) remove(out, k);
+        slot_staff_[s] = kEmpty;
+        if (in != kEmpty && !can_add(in, k)) {
+            if (out != kEmpty) add(out, k);
+            slot_staff_[s] = out;
+            return false;
+        }
+        if (in != kEmpty) add(in, k);
+        slot_staff_[s] = in;
+        return true;
+    }
+
+    // One random move at `temperature` (negative: evaluate and always undo). Returns the
+    // change in score, 0 for a move that was not possible.
+    double propose(double temperature) {
+        last_accepted_ = false;
+        const std::uint32_t s = movable_[rng_.below(static_cast<std::uint32_t>(movable_.size()))];
+        const std::uint32_t k = slot_shift_[s];
+        const std::uint32_t role = shifts_[k].role;
+        const double before = score();
+
+        std::uint32_t s2 = s;
+        std::uint32_t undo_s = kEmpty, undo_s2 = kEmpty;
+        if (rng_.below(2) == 0) {
+            // Put a random member of the role into the slot
+            const auto& staff = members_[role];
+            const std::uint32_t in = staff[rng_.below(static_cast<std::uint32_t>(staff.size()))];
+            undo_s = slot_staff_[s];
+            if (in == undo_s || !place(s, in)) return 0.0;
+        } else {
+            // Exchange the occupants of two slots of the role on different shifts
+            const auto& slots = role_slots_[role];
+            s2 = slots[rng_.below(static_cast<std::uint32_t>(slots.size()))];
+            const std::uint32_t x = slot_staff_[s];
+            const std::uint32_t y = slot_staff_[s2];
+            if (slot_shift_[s2] == k || x == y) return 0.0;
+            undo_s = x;
+            undo_s2 = y;
+            // Both leave first, so each is checked against the other's new shift only
+            if (!place(s2, kEmpty)) return 0.0;
+            if (!place(s, y)) {
+                place(s2, y);
+                return 0.0;
+            }
+            if (!place(s2, x)) {
+                place(s, x);
+                place(s2, y);
+                return 0.0;
+            }
+        }
+
+        const double delta = score() - before;
+        if (temperature >= 0 && (delta <= 0 || rng_.uniform() < std::exp(-delta / temperature))) {
+            last_accepted_ = true;
+            return delta;
+        }
+        if (s2 != s) {
+            place(s2, kEmpty);
+            place(s, undo_s);
+            place(s2, undo_s2);
+        } else {
+            place(s, undo_s);
+        }
+        return delta;
+    }
+
+    const InputModel& model_;
+    const PenaltyTable& penalties_;
+    const AnnealOptions& opt_;
+    ObjectiveWeights weights_;
+    SplitMix64 rng_;
+    EligibilityKernel kernel_;                           // roles, days, availability, skills
+    ConstraintSet hard_ = 0;
+
+    std::vector<std::vector<std::uint32_t>> members_;    // per role
+    std::vector<AnnealShift> shifts_;
+    std::int32_t n_days_ = 0;
+
+    std::vector<std::uint32_t> slot_staff_;              // worker per slot, kEmpty if open
+    std::vector<std::uint32_t> slot_shift_;
+    std::vector<std::vector<std::uint32_t>> role_slots_; // slots per role
+    std::vector<std::uint32_t> movable_;                 // slots of roles that have staff
+
+    // Incremental objective terms
+    std::vector<Minute> minutes_;
+    std::int64_t sum_ = 0;                               // of minutes
+    std::int64_t sum_sq_ = 0;                            // of minutes squared
+    std::vector<std::int32_t> nights_;
+    std::int64_t night_sum_ = 0;
+    std::int64_t night_sum_sq_ = 0;
+    long violations_ = 0;
+    long open_ = 0;
+    WorkerTimelines timelines_;
+    std::vector<std::uint8_t> day_count_;                // staff-major shifts per day
+
+    std::uint64_t moves_ = 0;
+    std::uint64_t accepted_ = 0;
+    bool last_accepted_ = false;
+};
+
+} // namespace
+
+AnnealOutcome anneal_assignments(const InputModel& model, const ScheduleResult& schedule,
+                                 const PenaltyTable& penalties, const AnnealOptions& opt) {
+    if (schedule.shift_count() == 0) {
+        AnnealOutcome out;
+        out.staff_offsets.assign(1, 0);
+        return out;
+    }
+    if (opt.time_budget_ms == 0 && opt.max_moves == 0) { // anneal mode is off: nothing to stop the loop
+        AnnealOutcome out;
+        out.staff_offsets = schedule.staff_offsets;
+        out.staff_index = schedule.staff_index;
+        return out;
+    }
+    Annealer annealer(model, schedule, penalties, opt);
+    return annealer.run();
+}
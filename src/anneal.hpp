@@ -0,0 +1,26 @@
+#pragma once
+#include "model.hpp"
+#include "engine.hpp"
+#include <cstdint>
+#include <vector>
+
+// Simulated annealing over a finished schedule. Every required slot is a position that
+// holds one worker or none; a move either puts a random staff member of the slot's role
+// into a slot, or exchanges the occupants of two slots of one role. Per-worker minutes and
+// nights, the sums behind their variances, preference violations and open slots are kept
+// current, so a move's delta costs a few array updates plus the rest check (one binary
+// search in the worker's timeline).
+
+struct AnnealOutcome {
+    std::vector<std::uint32_t> staff_offsets; // same layout as ScheduleResult
+    std::vector<std::uint32_t> staff_index;
+    AnnealStats stats;
+    bool improved = false;                    // the staff lists differ from the input's
+};
+
+// Anneal `schedule` (entries in start order) within opt's budget. Hard constraints are the
+// ones the rules select, checked like the engine does; the input is returned unchanged
+// unless the best schedule seen scores lower. Without a budget (time_budget_ms and
+// max_moves both 0) no move is made and the stats stay zero.
+AnnealOutcome anneal_assignments(const InputModel& model, const ScheduleResult& schedule,
+                                 const PenaltyTable& penalties, const AnnealOptions& opt);
@@ -0,0 +1,151 @@
+#pragma once
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+// Calendar math (proleptic Gregorian, days counted from 1970-01-01), usable at compile time
+
+struct CivilDate {
+    int y{}, m{}, d{};
+};
+
+constexpr bool is_leap_year(int y) noexcept {
+    return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+constexpr int days_in_month(int y, int m) noexcept {
+    constexpr int dim[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return (m == 2 && is_leap_year(y)) ? 29 : dim[m - 1];
+}
+
+// Days since 1970-01-01 (H. Hinnant's days_from_civil); d may run past the month end
+constexpr int days_from_civil(int y, int m, int d) noexcept {
+    y -= m <= 2;
+    const int era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = static_cast<unsigned>((153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1);
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int>(doe) - 719468;
+}
+
+// Inverse of days_from_civil
+constexpr CivilDate civil_from_days(int z) noexcept {
+    z += 719468;
+    const int era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int y = static_cast<int>(yoe) + era * 400;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const int d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    const int m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    return {y + (m <= 2), m, d};
+}
+
+// 0 = Sunday .. 6 = Saturday
+constexpr int weekday_from_days(int z) noexcept {
+    return z >= -4 ? (z + 4) % 7 : (z + 5) % 7 + 6;
+}
+
+// Floor division for possibly negative second counts
+constexpr std::int64_t floor_div(std::int64_t a, std::int64_t b) noexcept {
+    return a / b - ((a % b != 0) && ((a < 0) != (b < 0)));
+}
+
+static_assert(days_from_civil(1970, 1, 1) == 0);
+static_assert(days_from_civil(2000, 3, 1) == 11017);
+static_assert(days_from_civil(2025, 4, 31) == days_from_civil(2025, 5, 1));
+static_assert(civil_from_days(11017).y == 2000 && civil_from_days(11017).m == 3 && civil_from_days(11017).d == 1);
+static_assert(civil_from_days(-1).y == 1969 && civil_from_days(-1).d == 31);
+static_assert(weekday_from_days(days_from_civil(2025, 4, 7)) == 1); // a Monday
+
+// Fixed-width decimal field; no allocation, no branches on the digits themselves
+template <int N>
+constexpr bool parse_fixed_digits(const char* p, int& out) noexcept {
+    int v = 0;
+    unsigned bad = 0;
+    for (int i = 0; i < N; ++i) {
+        unsigned c = static_cast<unsigned>(static_cast<unsigned char>(p[i])) - '0';
+        bad |= static_cast<unsigned>(c > 9);
+        v = v * 10 + static_cast<int>(c);
+    }
+    out = v;
+    return bad == 0;
+}
+
+// Local wall clock -> UTC
+
+namespace civil_time_detail {
+
+inline std::int64_t mktime_local(int y, int m, int d, int H, int M) {
+    std::tm tm{};
+    tm.tm_year = y - 1900;
+    tm.tm_mon  = m - 1;
+    tm.tm_mday = d;
+    tm.tm_hour = H;
+    tm.tm_min  = M;
+    tm.tm_sec  = 0;
+    tm.tm_isdst = -1; // let the timezone database decide
+    return static_cast<std::int64_t>(std::mktime(&tm));
+}
+
+// UTC offset (local minus UTC, seconds) per local day. Days whose offset changes
+// (DST transitions) are marked and always resolved through mktime.
+struct OffsetCache {
+    static constexpr std::int32_t kUnknown = INT32_MIN;
+    static constexpr std::int32_t kTransition = INT32_MIN + 1;
+    static constexpr int kMaxDays = 1 << 16; // ~180 years; wider spans bypass the cache
+
+    int first_day = 0;
+    std::vector<std::int32_t> offsets;
+
+    // Slot for `day`, or nullptr if it would make the table too large
+    std::int32_t* slot(int day) {
+        if (offsets.empty()) {
+            first_day = day;
+            offsets.assign(1, kUnknown);
+        } else if (day < first_day) {
+            if (first_day - day + static_cast<int>(offsets.size()) > kMaxDays) return nullptr;
+            offsets.insert(offsets.begin(), static_cast<size_t>(first_day - day), kUnknown);
+            first_day = day;
+        } else if (day - first_day >= static_cast<int>(offsets.size())) {
+            if (day - first_day >= kMaxDays) return nullptr;
+            offsets.resize(static_cast<size_t>(day - first_day) + 1, kUnknown);
+        }
+        return &offsets[static_cast<size_t>(day - first_day)];
+    }
+};
+
+inline OffsetCache& offset_cache() {
+    thread_local OffsetCache cache;
+    return cache;
+}
+
+} // namespace civil_time_detail
+
+// Forget cached offsets (call after changing TZ in-process)
+inline void clear_utc_offset_cache() {
+    civil_time_detail::offset_cache() = civil_time_detail::OffsetCache{};
+}
+
+// Seconds since the epoch for a local wall-clock time; same result as mktime with
+// tm_isdst = -1, but only calls it twice per distinct day (plus every call on DST days)
+inline std::int64_t local_to_utc_seconds(int y, int m, int d, int H, int M) {
+    using namespace civil_time_detail;
+    std::int64_t local = (static_cast<std::int64_t>(days_from_civil(y, m, 1)) + d - 1) * 86400 +
+                         static_cast<std::int64_t>(H) * 3600 + static_cast<std::int64_t>(M) * 60;
+    int day = static_cast<int>(floor_div(local, 86400));
+
+    std::int32_t* off = offset_cache().slot(day);
+    if (!off) return mktime_local(y, m, d, H, M);
+    if (*off == OffsetCache::kUnknown) {
+        CivilDate c = civil_from_days(day);
+        std::int64_t midnight = static_cast<std::int64_t>(day) * 86400;
+        std::int64_t a = midnight - mktime_local(c.y, c.m, c.d, 0, 0);
+        std::int64_t b = midnight + 86340 - mktime_local(c.y, c.m, c.d, 23, 59);
+        *off = (a == b) ? static_cast<std::int32_t>(a) : OffsetCache::kTransition;
+    }
+    if (*off == OffsetCache::kTransition) return mktime_local(y, m, d, H, M);
+    return local - *off;
+}
@@ -0,0 +1,55 @@
+#include "constraints.hpp"
+
+#include <algorithm>
+#include <string_view>
+
+namespace {
+
+struct Entry {
+    std::string_view name;
+    ConstraintSet bits;
+};
+
+// Hard constraint names. "coverage" is the engine's goal rather than a filter, and role and
+// availability are always on; both are accepted so existing inputs stay valid, but only a
+// name with bits replaces the defaults (["coverage"] alone keeps them).
+constexpr Entry kHard[] = {
+    {"role", constraint::role},
+    {"availability", constraint::availability},
+    {"weekly_hours", constraint::weekly_hours},
+    {"rest", constraint::rest},
+    {"consecutive_days", constraint::consecutive_days},
+    {"skills", constraint::skills},
+    {"legal_limits", constraint::legal_limits},
+    {"coverage", 0},
+};
+
+constexpr std::string_view kSoft[] = {"fairness", "preferences"};
+
+} // namespace
+
+ConstraintSelection select_constraints(const Rules& rules) {
+    ConstraintSelection sel;
+
+    ConstraintSet named = 0;
+    for (const auto& name : rules.hard_constraints) {
+        auto it = std::find_if(std::begin(kHard), std::end(kHard), [&](const Entry& e) { return e.name == name; });
+        if (it == std::end(kHard)) {
+            sel.unknown.push_back(name);
+            continue;
+        }
+        named |= it->bits;
+    }
+    if (named) sel.hard = constraint::always | named;
+
+    if (!rules.soft_constraints.empty()) {
+        sel.fairness = rules.soft_constraints.count("fairness") != 0;
+        sel.preferences = rules.soft_constraints.count("preferences") != 0;
+        for (const auto& name : rules.soft_constraints) {
+            if (std::find(std::begin(kSoft), std::end(kSoft), name) == std::end(kSoft)) sel.unknown.push_back(name);
+        }
+    }
+
+    std::sort(sel.unknown.begin(), sel.unknown.end()); // the sets are unordered
+    return sel;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "model.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Hard constraints the engine can enforce, one bit each so a whole set is tested in
+// a single fused filter. Names (as used in Rules::hard_constraints) are in the registry
+// in constraints.cpp.
+using ConstraintSet = std::uint32_t;
+
+namespace constraint {
+inline constexpr ConstraintSet role             = 1u << 0; // staff role is the shift's role
+inline constexpr ConstraintSet availability     = 1u << 1; // no can_work=false entry for the day
+inline constexpr ConstraintSet weekly_hours     = 1u << 2; // assigned time + shift within max_weekly_hours
+inline constexpr ConstraintSet rest             = 1u << 3; // min_rest hours since the previous shift
+inline constexpr ConstraintSet consecutive_days = 1u << 4; // run of worked days within max_consecutive_days
+inline constexpr ConstraintSet skills           = 1u << 5; // staff has every skill the shift requires
+
+inline constexpr ConstraintSet legal_limits = weekly_hours | rest; // consecutive_days is named on its own
+inline constexpr ConstraintSet always       = role | availability; // enforced whatever the rules say
+inline constexpr ConstraintSet defaults     = always | legal_limits; // when no name with bits is given
+} // namespace constraint
+
+// What the rules ask the engine to do
+struct ConstraintSelection {
+    ConstraintSet hard = constraint::defaults;
+    bool fairness = true;    // soft: "fairness" (on when soft_constraints is empty)
+    bool preferences = true; // soft: "preferences" (on when soft_constraints is empty)
+    std::vector<std::string> unknown; // names in either set that are not in the registry
+};
+
+// Resolve the rule names once per run (the engine never looks at the strings again)
+ConstraintSelection select_constraints(const Rules& rules);
@@ -0,0 +1,282 @@
+#include "csv_writer.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// Helper Functions
+
+// Format time into string for CSV
+static std::string format_time(const SysTime& t) {
+    std::time_t tt = Clock::to_time_t(t);
+    std::tm* tm = std::localtime(&tt);
+    char buf[32];
+    if (std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M", tm)) {
+        return std::string(buf);
+    }
+    return "";
+}
+
+// Write a free-text field, quoted per RFC 4180 when it holds a comma, quote or line break
+static void write_text_field(std::ostream& out, const std::string& text) {
+    if (text.find_first_of(",\"\r\n") == std::string::npos) {
+        out << text;
+        return;
+    }
+    out << '"';
+    for (char c : text) {
+        if (c == '"') out << '"';
+        out << c;
+    }
+    out << '"';
+}
+
+// Write the staff ids of result entry k, separated by `sep`
+static void write_staff_ids(std::ostream& out, const InputModel& model, const ScheduleResult& result,
+                            size_t k, const char* sep) {
+    for (const std::uint32_t* p = result.staff_begin(k); p != result.staff_end(k); ++p) {
+        if (p != result.staff_begin(k)) out << sep;
+        out << model.staff[*p].id;
+    }
+}
+
+// Schedule CSV Writer
+void write_schedule_csv(const InputModel& model, const ScheduleResult& result, std::ostream& out) {
+    // Shift index -> result entry (-1 if the shift was not scheduled)
+    std::vector<std::int32_t> entry_of(model.shifts.size(), -1);
+    for (size_t k = 0; k < result.shift_count(); ++k) {
+        entry_of[result.shift_index[k]] = static_cast<std::int32_t>(k);
+    }
+
+    // Unique shifts already sorted by start time (see InputModel::shift_order)
+    std::vector<std::uint32_t> order_scratch;
+    const auto& order = shift_order_of(model, order_scratch);
+
+    // CSV Headers
+    out << "shift_id,unit,start,end,required_role,required_count,"
+           "assigned_count,assigned_staff_ids,coverage_ok,missing_count\n";
+
+    // Extract data from assignments
+    for (std::uint32_t idx : order) {
+        const Shifts* sh = &model.shifts[idx];
+        const std::int32_t k = entry_of[idx];
+
+        int assigned_count = k >= 0 ? static_cast<int>(result.staff_count(static_cast<size_t>(k))) : 0;
+        int required = sh->required_count;
+        bool coverage_ok = (assigned_count >= required);
+        int missing = (required > assigned_count) ? (required - assigned_count) : 0;
+
+        // Format output to cells
+        out << sh->id << ","
+            << sh->name << ","
+            << format_time(sh->start) << ","
+            << format_time(sh->end) << ","
+            << sh->req_role << ","
+            << required << ","
+            << assigned_count << ",";
+        if (k >= 0) write_staff_ids(out, model, result, static_cast<size_t>(k), ";");
+        out << ","
+            << (coverage_ok ? "Yes" : "No") << ","
+            << missing << "\n";
+    }
+}
+
+bool write_schedule_csv(const InputModel& model, const ScheduleResult& result, const std::string& csv_path) {
+    std::ofstream out(csv_path);
+    if (!out) {
+        std::cerr << "Error: Cannot open CSV file for writing: " << csv_path << "\n";
+        return false;
+    }
+    write_schedule_csv(model, result, out);
+    return true;
+}
+
+// Staff summary CSV (hours per staff) writer
+void write_staff_summary_csv(const InputModel& model, const ScheduleResult& result, std::ostream& out) {
+    // Headers
+    out << "staff_id,name,role,total_hours\n";
+
+    // Loop through staff to get data (totals come from the engine, same order as model.staff)
+    for (size_t i = 0; i < model.staff.size(); ++i) {
+        const Staff& s = model.staff[i];
+        std::int32_t m = i < result.staff_totals.size() ? result.staff_totals[i].minutes : 0;
+        double hours = static_cast<double>(m) / 60.0; // 7.5 for 07:30-15:00
+
+        // Format data
+        out << s.id << ","
+            << s.name << ","
+            << s.role << ","
+            << hours << "\n";
+    }
+}
+
+bool write_staff_summary_csv(const InputModel& model, const ScheduleResult& result, const std::string& csv_path) {
+    std::ofstream out(csv_path);
+    if (!out) {
+        std::cerr << "Error: Cannot open CSV file for writing: " << csv_path << "\n";
+        return false;
+    }
+    write_staff_summary_csv(model, result, out);
+    return true;
+}
+
+// Warnings CSV writer
+void write_warnings_csv(const ScheduleResult& result, std::ostream& out) {
+    // Adds warnings to CSV
+    out << "index,warning\n";
+    for (size_t i = 0; i < result.warnings.size(); ++i) {
+        out << i << "," << result.warnings[i] << "\n";
+    }
+}
+
+bool write_warnings_csv(const ScheduleResult& result, const std::string& csv_path) {
+    std::ofstream out(csv_path);
+    if (!out) {
+        std::cerr << "Error: Cannot open CSV file for writing: " << csv_path << "\n";
+        return false;
+    }
+    write_warnings_csv(result, out);
+    return true;
+}
+
+// Diagnostics CSV writer (rejection reasons per shift)
+void write_diagnostics_csv(const ScheduleResult& result, std::ostream& out) {
+    // Headers
+    out << "shift_id,eligible,rejected_role,rejected_availability,rejected_hours,rejected_rest,"
+           "rejected_consecutive_days,rejected_skills\n";
+    for (const auto& d : result.diagnostics) {
+        out << d.shift_id << ","
+            << d.eligible << ","
+            << d.rejected_role << ","
+            << d.rejected_availability << ","
+            << d.rejected_hours << ","
+            << d.rejected_rest << ","
+            << d.rejected_consecutive_days << ","
+            << d.rejected_skills << "\n";
+    }
+}
+
+bool write_diagnostics_csv(const ScheduleResult& result, const std::string& csv_path) {
+    std::ofstream out(csv_path);
+    if (!out) {
+        std::cerr << "Error: Cannot open CSV file for writing: " << csv_path << "\n";
+        return false;
+    }
+    write_diagnostics_csv(result, out);
+    return true;
+}
+
+// Scenario comparison CSV writer (one row per what-if scenario)
+void write_scenarios_csv(const std::vector<ScenarioMetrics>& scenarios, std::ostream& out) {
+    // Headers
+    out << "scenario,staff,shifts,required_slots,filled_slots,short_shifts,coverage_pct,"
+           "mean_hours,stddev_hours,min_hours,max_hours,preference_violations,stddev_nights,score,warnings,elapsed_ms\n";
+    for (const auto& m : scenarios) {
+        write_text_field(out, m.name);
+        out << ","
+            << m.staff << ","
+            << m.shifts << ","
+            << m.required_slots << ","
+            << m.filled_slots << ","
+            << m.short_shifts << ","
+            << m.coverage_pct << ","
+            << m.mean_hours << ","
+            << m.stddev_hours << ","
+            << m.min_hours << ","
+            << m.max_hours << ","
+            << m.preference_violations << ","
+            << m.stddev_nights << ","
+            << m.score << ","
+            << m.warnings << ","
+            << m.elapsed_ms << "\n";
+    }
+}
+
+bool write_scenarios_csv(const std::vector<ScenarioMetrics>& scenarios, const std::string& csv_path) {
+    std::ofstream out(csv_path);
+    if (!out) {
+        std::cerr << "Error: Cannot open CSV file for writing: " << csv_path << "\n";
+        return false;
+    }
+    write_scenarios_csv(scenarios, out);
+    return true;
+}
+
+// Call-out simulation CSV writer (one row per metric, distribution over the samples)
+void write_simulation_csv(const SimulationReport& report, std::ostream& out) {
+    // Headers
+    out << "metric,mean,min,p5,p50,p95,p99,max\n";
+    auto row = [&](const char* name, const Distribution& d) {
+        out << name << ","
+            << d.mean << ","
+            << d.min << ","
+            << d.p5 << ","
+            << d.p50 << ","
+            << d.p95 << ","
+            << d.p99 << ","
+            << d.max << "\n";
+    };
+    row("vacated_slots", report.vacated_slots);
+    row("repaired_slots", report.repaired_slots);
+    row("uncovered_slots", report.uncovered_slots);
+    row("uncovered_shifts", report.uncovered_shifts);
+    row("coverage_pct", report.coverage_pct);
+}
+
+bool write_simulation_csv(const SimulationReport& report, const std::string& csv_path) {
+    std::ofstream out(csv_path);
+    if (!out) {
+        std::cerr << "Error: Cannot open CSV file for writing: " << csv_path << "\n";
+        return false;
+    }
+    write_simulation_csv(report, out);
+    return true;
+}
+
+// Pre-solve CSV writer (one row per slice with an unavoidable shortfall)
+void write_presolve_csv(const PresolveReport& report, std::ostream& out) {
+    // Headers
+    out << "role,start,end,shifts,demand,supply,shortfall\n";
+    for (const auto& sl : report.slices) {
+        out << sl.role << ","
+            << format_time(sl.start) << ","
+            << format_time(sl.end) << ","
+            << sl.shifts << ","
+            << sl.demand << ","
+            << sl.supply << ","
+            << sl.shortfall << "\n";
+    }
+}
+
+bool write_presolve_csv(const PresolveReport& report, const std::string& csv_path) {
+    std::ofstream out(csv_path);
+    if (!out) {
+        std::cerr << "Error: Cannot open CSV file for writing: " << csv_path << "\n";
+        return false;
+    }
+    write_presolve_csv(report, out);
+    return true;
+}
+
+// Schedule audit CSV writer (one row per violation)
+void write_violations_csv(const std::vector<Violation>& violations, std::ostream& out) {
+    // Headers
+    out << "kind,staff_id,shift_id,detail\n";
+    for (const auto& v : violations) {
+        out << violation_name(v.kind) << ","
+            << v.staff_id << ","
+            << v.shift_id << ","
+            << v.detail << "\n";
+    }
+}
+
+bool write_violations_csv(const std::vector<Violation>& violations, const std::string& csv_path) {
+    std::ofstream out(csv_path);
+    if (!out) {
+        std::cerr << "Error: Cannot open CSV file for writing: " << csv_path << "\n";
+        return false;
+    }
+    write_violations_csv(violations, out);
+    return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "model.hpp"
+#include "engine.hpp"
+#include "scenario.hpp"
+#include "simulation.hpp"
+#include "presolve.hpp"
+#include "validate.hpp"
+#include <ostream>
+#include <string>
+
+// Stream writers (format only)
+void write_schedule_csv(const InputModel& model, const ScheduleResult& result, std::ostream& out);
+void write_staff_summary_csv(const InputModel& model, const ScheduleResult& result, std::ostream& out);
+void write_warnings_csv(const ScheduleResult& result, std::ostream& out);
+void write_diagnostics_csv(const ScheduleResult& result, std::ostream& out);
+void write_scenarios_csv(const std::vector<ScenarioMetrics>& scenarios, std::ostream& out);
+void write_simulation_csv(const SimulationReport& report, std::ostream& out);
+void write_presolve_csv(const PresolveReport& report, std::ostream& out);
+void write_violations_csv(const std::vector<Violation>& violations, std::ostream& out);
+
+// File writers (false and a message on stderr if the file can't be opened)
+bool write_schedule_csv(const InputModel& model, const ScheduleResult& result, const std::string& csv_path);
+bool write_staff_summary_csv(const InputModel& model, const ScheduleResult& result, const std::string& csv_path);
+bool write_warnings_csv(const ScheduleResult& result, const std::string& csv_path);
+bool write_diagnostics_csv(const ScheduleResult& result, const std::string& csv_path);
+bool write_scenarios_csv(const std::vector<ScenarioMetrics>& scenarios, const std::string& csv_path);
+bool write_simulation_csv(const SimulationReport& report, const std::string& csv_path);
+bool write_presolve_csv(const PresolveReport& report, const std::string& csv_path);
+bool write_violations_csv(const std::vector<Violation>& violations, const std::string& csv_path);
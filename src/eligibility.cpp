@@ -0,0 +1,87 @@
+#include "eligibility.hpp"
+#include "civil_time.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <string_view>
+#include <unordered_map>
+
+bool available_on(const Staff& s, const DateStamp& day) {
+    for (const auto& a : s.availability) {
+        if (a.date.y == day.y && a.date.m == day.m && a.date.d == day.d) {
+            return a.can_work;
+        }
+    }
+    return true; // Assume can work
+}
+
+EligibilityKernel::EligibilityKernel(const InputModel& model, const std::vector<std::uint32_t>& shifts, ConstraintSet hard)
+    : model_(model), hard_(hard) {
+    // Roles interned in staff order, so no check compares strings
+    std::unordered_map<std::string_view, std::uint32_t> role_ids;
+    staff_role_.reserve(model.staff.size());
+    for (const auto& s : model.staff) {
+        auto it = role_ids.try_emplace(s.role, role_count_).first;
+        if (it->second == role_count_) ++role_count_;
+        staff_role_.push_back(it->second);
+    }
+
+    // Per shift: role, local day and exact length
+    shift_role_.assign(shifts.size(), kNoRole);
+    shift_day_.resize(shifts.size());
+    minutes_.resize(shifts.size());
+    z0_ = INT_MAX;
+    for (size_t k = 0; k < shifts.size(); ++k) {
+        const Shifts& sh = model.shifts[shifts[k]];
+        auto it = role_ids.find(sh.req_role);
+        if (it != role_ids.end()) shift_role_[k] = it->second;
+        const DateStamp day = sh.day();
+        shift_day_[k] = days_from_civil(day.y, day.m, day.d);
+        z0_ = std::min(z0_, shift_day_[k]);
+        minutes_[k] = static_cast<std::int32_t>(sh.duration_minutes().count());
+    }
+    if (shifts.empty()) z0_ = 0;
+    for (auto& d : shift_day_) {
+        d -= z0_;
+        n_days_ = std::max(n_days_, d + 1);
+    }
+    day_words_ = (static_cast<size_t>(n_days_) + 63) / 64;
+
+    // Availability per (staff, day). Entries are applied last to first, so the first entry
+    // for a day decides, as in available_on.
+    off_.assign(model.staff.size() * static_cast<size_t>(n_days_), 0);
+    for (size_t w = 0; w < model.staff.size(); ++w) {
+        const auto& entries = model.staff[w].availability;
+        for (auto a = entries.rbegin(); a != entries.rend(); ++a) {
+            const int d = days_from_civil(a->date.y, a->date.m, a->date.d) - z0_;
+            if (d >= 0 && d < n_days_) off_[w * static_cast<size_t>(n_days_) + static_cast<size_t>(d)] = !a->can_work;
+        }
+    }
+
+    // Required skills interned to bits; staff and shift skill sets as bitsets
+    if (!(hard_ & constraint::skills)) return;
+    std::unordered_map<std::string_view, std::uint32_t> skill_ids;
+    for (std::uint32_t idx : shifts) {
+        for (const auto& sk : model.shifts[idx].req_skills) {
+            skill_ids.try_emplace(sk, static_cast<std::uint32_t>(skill_ids.size()));
+        }
+    }
+    if (skill_ids.empty()) {
+        hard_ &= ~constraint::skills; // nothing to check
+        return;
+    }
+    skill_words_ = (skill_ids.size() + 63) / 64;
+    auto set_bit = [](std::uint64_t* words, std::uint32_t bit) { words[bit >> 6] |= std::uint64_t{1} << (bit & 63); };
+    shift_skills_.assign(shifts.size() * skill_words_, 0);
+    for (size_t k = 0; k < shifts.size(); ++k) {
+        for (const auto& sk : model.shifts[shifts[k]].req_skills) set_bit(&shift_skills_[k * skill_words_], skill_ids[sk]);
+    }
+    staff_skills_.assign(model.staff.size() * skill_words_, 0);
+    for (size_t w = 0; w < model.staff.size(); ++w) {
+        for (const auto& sk : model.staff[w].skills) {
+            auto it = skill_ids.find(sk);
+            if (it != skill_ids.end()) set_bit(&staff_skills_[w * skill_words_], it->second);
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include "model.hpp"
+#include "constraints.hpp"
+#include <cstdint>
+#include <vector>
+
+// Eligibility kernel: the hard constraints of constraints.hpp over interned ids, built once
+// per run for a list of shifts. The engine, exact and anneal mode, the pre-solve analysis
+// and the call-out simulation all check staff through it, so each rule has one definition.
+// Checks that depend on what a worker already has (hours, consecutive days) take the
+// caller's state; rest stays with the caller's WorkerTimelines.
+
+// Check availability by date: the first entry for the day decides, no entry means available
+bool available_on(const Staff& s, const DateStamp& day);
+
+// Check the run of worked days through `day` stays within `limit`; worked(d) tells whether
+// day d (0 .. n_days - 1) is worked already
+template <class Worked>
+bool consecutive_run_ok(const Worked& worked, std::int32_t day, std::int32_t n_days, std::int32_t limit) {
+    if (day < 0 || worked(day)) return true; // already working that day: the run does not grow
+    std::int32_t run = 1;
+    for (std::int32_t d = day - 1; d >= 0 && run <= limit && worked(d); --d) ++run;
+    for (std::int32_t d = day + 1; d < n_days && run <= limit && worked(d); ++d) ++run;
+    return run <= limit;
+}
+
+class EligibilityKernel {
+public:
+    static constexpr std::uint32_t kNoRole = UINT32_MAX;
+
+    // `shifts` are indices into model.shifts; position k below is shifts[k]. Days count
+    // from the earliest shift's local day. Skills are dropped from `hard` when no shift
+    // requires any.
+    EligibilityKernel(const InputModel& model, const std::vector<std::uint32_t>& shifts, ConstraintSet hard);
+
+    ConstraintSet hard() const { return hard_; }
+    std::uint32_t role_count() const { return role_count_; }
+    std::uint32_t staff_role(size_t w) const { return staff_role_[w]; } // in order of first appearance
+    std::uint32_t shift_role(size_t k) const { return shift_role_[k]; } // kNoRole if no staff has it
+    std::int32_t day_count() const { return n_days_; }
+    std::int32_t shift_day(size_t k) const { return shift_day_[k]; }
+    int first_day() const { return z0_; } // day 0 as days_from_civil
+    size_t day_words() const { return day_words_; } // length of a worked-days bitset
+
+    // Always enforced
+    bool role_ok(size_t w, size_t k) const { return shift_role_[k] != kNoRole && staff_role_[w] == shift_role_[k]; }
+    bool available(size_t w, std::int32_t day) const {
+        return !off_[w * static_cast<size_t>(n_days_) + static_cast<size_t>(day)];
+    }
+
+    // Selected by the rules; true when the constraint is not
+    bool hours_ok(size_t w, std::int64_t assigned_minutes, size_t k) const {
+        return !(hard_ & constraint::weekly_hours) ||
+               assigned_minutes + minutes_[k] <= std::int64_t{model_.staff[w].max_weekly_hours} * 60;
+    }
+    bool skills_ok(size_t w, size_t k) const {
+        const std::uint64_t* have = &staff_skills_[w * skill_words_];
+        const std::uint64_t* need = &shift_skills_[k * skill_words_];
+        for (size_t i = 0; i < skill_words_; ++i) {
+            if (need[i] & ~have[i]) return false;
+        }
+        return true;
+    }
+    template <class Worked>
+    bool consecutive_ok_with(const Worked& worked, size_t w, size_t k) const {
+        return !(hard_ & constraint::consecutive_days) ||
+               consecutive_run_ok(worked, shift_day_[k], n_days_, model_.staff[w].max_consecutive_days);
+    }
+    // `days` is the worker's bitset of worked days (day_words() long)
+    bool consecutive_ok(const std::uint64_t* days, size_t w, size_t k) const {
+        return consecutive_ok_with([days](std::int32_t d) { return ((days[d >> 6] >> (d & 63)) & 1u) != 0; }, w, k);
+    }
+    void mark_day(std::uint64_t* days, size_t k) const {
+        const std::int32_t d = shift_day_[k];
+        days[d >> 6] |= std::uint64_t{1} << (d & 63);
+    }
+    void clear_day(std::uint64_t* days, size_t k) const {
+        const std::int32_t d = shift_day_[k];
+        days[d >> 6] &= ~(std::uint64_t{1} << (d & 63));
+    }
+
+    // Role, availability, skills and an hour cap that fits the shift at all: everything
+    // that does not depend on what the worker already has
+    bool static_ok(size_t w, size_t k) const {
+        return role_ok(w, k) && available(w, shift_day_[k]) && skills_ok(w, k) && hours_ok(w, 0, k);
+    }
+
+private:
+    const InputModel& model_;
+    ConstraintSet hard_;
+    std::uint32_t role_count_ = 0;
+    std::vector<std::uint32_t> staff_role_;
+    std::vector<std::uint32_t> shift_role_;
+    std::vector<std::int32_t> shift_day_;
+    std::vector<std::int32_t> minutes_;        // per shift
+    int z0_ = 0;
+    std::int32_t n_days_ = 0;
+    size_t day_words_ = 0;
+    std::vector<std::uint8_t> off_;            // staff-major: 1 if unavailable that day
+    size_t skill_words_ = 0;                   // 0 unless skills are checked
+    std::vector<std::uint64_t> staff_skills_;  // interned bitsets, skill_words_ per staff
+    std::vector<std::uint64_t> shift_skills_;  // and per shift
+};
@@ -1,82 +1,171 @@
 #include "engine.hpp"
+#include "anneal.hpp"
+#include "constraints.hpp"
+#include "eligibility.hpp"
+#include "exact.hpp"
+#include "profiler.hpp"
+#include "rng.hpp"
+#include "timeline.hpp"
 #include <algorithm>
-#include <optional>
+#include <cassert>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
 #include <sstream>
+#include <string_view>
+#include <unordered_map>
+
+// Engine time: int32 minutes since the horizon start (earliest shift start).
+// Wall-clock values are converted once on the way in; output still uses the Shifts.
+using Minute = std::int32_t;
+static constexpr std::uint32_t kNoRole = EligibilityKernel::kNoRole;
+
+// Shift as seen by the engine
+struct EngineShift {
+    const Shifts* src;
+    Minute start;
+    Minute end;
+    bool night;    // Shifts::is_night(), evaluated once
+    std::int32_t week; // week of the horizon (weeks start on Monday)
+    std::uint32_t role; // index of the role's fairness heap (kNoRole if no staff has it)
+    std::uint32_t unit; // column in the penalty table
+    Minute duration() const { return end - start; }
+};
+
+// Loop records kept in the scratch arena (no strings until the loop is done)
+struct Shortfall {
+    std::uint32_t pos;    // index into the shifts in start order
+    int need;
+    bool none_eligible;
+};
+
+struct DiagCounts {
+    int eligible;
+    int rejected_role;
+    int rejected_availability;
+    int rejected_hours;
+    int rejected_rest;
+    int rejected_consecutive_days;
+    int rejected_skills;
+};
+
+// First hard constraint a worker fails for a shift
+enum class Reject : std::uint8_t { None, Role, Availability, Hours, Rest, ConsecutiveDays, Skills };
 
 // Helper Functions
- 
-// Check availability by date
-static bool available_on(const Staff& s, const DateStamp& day) {
-    if (s.availability.empty()) return true;
-    for (const auto& a : s.availability) {
-        if (a.date.y == day.y && a.date.m == day.m && a.date.d == day.d) {
-            return a.can_work;
-        }
-    }
-    return true; // Assume can work
-}
 
 struct WorkerState {
     const Staff* staff;
-    Hours assigned_hours{0};
-    std::optional<SysTime> last_end{};
+    std::uint32_t id_rank{0};    // position in id order, or the seeded order (ties in the ranking)
+    std::uint32_t role{kNoRole}; // interned role (same ids as EngineShift::role)
+    Minute assigned_minutes{0};  // exact time worked so far
 };
 
-// Check at least min_rest_hours between end and next start
-static bool has_rest(const WorkerState& ws, const Staff& s, const Shifts& sh) {
-    if (!ws.last_end) return true;
-    auto rest = std::chrono::duration_cast<Hours>(sh.start - *ws.last_end);
-    return rest.count() >= s.min_rest;
+// Check at least min_rest hours to the worker's shifts before and after this one
+// (both sides, so shifts may be staffed in any order)
+static bool has_rest(const WorkerTimelines& timelines, size_t w, const Staff& s, const EngineShift& sh) {
+    return timelines.fits(w, sh.start, sh.end, Minute{s.min_rest} * 60);
 }
 
-// Check role matches
-static bool role_ok(const Staff& s, const Shifts& sh) {
-    return s.role == sh.req_role;
+// Loop policies: which ranking criteria and bookkeeping the scheduling loop does.
+// StaticPolicy fixes them at compile time; RuntimePolicy reads them from the options
+// (used with diagnostics, and as the benchmark baseline).
+template <bool Fairness, bool Preferences>
+struct StaticPolicy {
+    static constexpr bool fairness() { return Fairness; }
+    static constexpr bool preferences() { return Preferences; }
+    static constexpr bool diagnostics() { return false; }
+    static constexpr bool heap_path() { return Fairness; }
+};
+
+struct RuntimePolicy {
+    bool fairness_on;
+    bool preferences_on;
+    bool diagnostics_on;
+    bool fairness() const { return fairness_on; }
+    bool preferences() const { return preferences_on; }
+    bool diagnostics() const { return diagnostics_on; }
+    bool heap_path() const { return fairness_on && !diagnostics_on; }
+};
+
+std::uint64_t penalty_staff_key(const std::vector<Staff>& staff) {
+    const std::hash<std::string> hash;
+    std::uint64_t key = splitmix64(staff.size());
+    for (const Staff& s : staff) {
+        std::uint64_t units = 0; // the set is unordered: combine its members commutatively
+        for (const auto& u : s.prefs.preferred_unit) units += splitmix64(hash(u));
+        key = splitmix64(key ^ hash(s.id));
+        key = splitmix64(key ^ units ^ (s.prefs.avoid_nights ? 1u : 0u));
+    }
+    return key;
 }
 
-// Check for hours
-static bool legal_hours_ok(const WorkerState& ws, const Staff& s, const Shifts& sh) {
-    auto cap = Hours{s.max_weekly_hours};
-    return (ws.assigned_hours + sh.duration()) <= cap;
+bool PenaltyTable::built_for(const InputModel& model) const {
+    if (staff_count != model.staff.size() || staff_key != penalty_staff_key(model.staff)) return false;
+    for (const auto& sh : model.shifts) {
+        if (!unit_column.count(sh.name)) return false; // would fall into the "other" column
+    }
+    return true;
 }
 
-// Calculate preference weight
-static int preference_penalty(const Staff& s, const Shifts& sh) {
-    int p = 0;
-    if (s.prefs.avoid_nights && sh.is_night()) p += 5;
-    if (!s.prefs.preferred_unit.empty() &&
-        s.prefs.preferred_unit.count(sh.name) == 0) {
-        p += 1;
+// Preference weights for every (staff, unit) pair of the model
+PenaltyTable build_penalty_table(const InputModel& model) {
+    PenaltyTable t;
+    t.staff_count = model.staff.size();
+    t.staff_key = penalty_staff_key(model.staff);
+    for (const auto& sh : model.shifts) {
+        t.unit_column.try_emplace(sh.name, static_cast<std::uint32_t>(t.unit_column.size()));
     }
-    return p;
+    t.columns = t.unit_column.size() + 1;
+
+    t.unit_penalty.assign(t.staff_count * t.columns, 0);
+    t.night_penalty.assign(t.staff_count, 0);
+    for (size_t i = 0; i < t.staff_count; ++i) {
+        const Staff& s = model.staff[i];
+        if (s.prefs.avoid_nights) t.night_penalty[i] = PenaltyTable::kNightPenalty;
+        if (s.prefs.preferred_unit.empty()) continue;
+        std::uint8_t* row = &t.unit_penalty[i * t.columns];
+        for (size_t c = 0; c < t.columns; ++c) row[c] = PenaltyTable::kUnitPenalty;
+        for (const auto& u : s.prefs.preferred_unit) {
+            auto it = t.unit_column.find(u);
+            if (it != t.unit_column.end()) row[it->second] = 0;
+        }
+    }
+    return t;
 }
 
 // Build Schedule
 ScheduleResult build_schedule(const InputModel& input, const EngineOptions& opt) {
     ScheduleResult result;
 
-    // Unique shift check (No duplicates)
-    std::unordered_map<std::string, Shifts> unique_by_id;
-    unique_by_id.reserve(input.shifts.size());
+    // Constant false when compiled out, so the counters below disappear from the filter loop
+    const bool diag_on = (HOS_DIAGNOSTICS != 0) && opt.diagnostics;
 
-    for (const auto& sh : input.shifts) {
-        auto it = unique_by_id.find(sh.id);
-        if (it == unique_by_id.end()) {
-            unique_by_id.emplace(sh.id, sh);
-        }
-    }
+    Profiler* prof = opt.profiler;
 
-    // Make a vector of unique shifts and sort by start time
-    std::vector<Shifts> shifts;
-    shifts.reserve(unique_by_id.size());
-    for (auto& kv : unique_by_id) {
-        shifts.push_back(std::move(kv.second));
-    }
+    // Unique shifts in start order, as indices into input.shifts (no Shifts copies)
+    std::vector<std::uint32_t> order_scratch;
+    std::vector<EngineShift> eshifts;
+    {
+        ScopedTimer timer(prof, Phase::ShiftDedup);
+        const auto& order = shift_order_of(input, order_scratch);
 
-    std::sort(shifts.begin(), shifts.end(),
-              [](const Shifts& a, const Shifts& b) {
-                  return a.start < b.start;
-              });
+        // Convert to engine minutes once (local days come from the eligibility kernel below,
+        // so the loop never calls localtime)
+        eshifts.reserve(order.size());
+        if (!order.empty()) {
+            const SysTime horizon = input.shifts[order.front()].start;
+            auto minutes_since = [&](const SysTime& t) {
+                return static_cast<Minute>(std::chrono::duration_cast<std::chrono::minutes>(t - horizon).count());
+            };
+            for (std::uint32_t idx : order) {
+                const Shifts& sh = input.shifts[idx];
+                eshifts.push_back(EngineShift{&sh, minutes_since(sh.start), minutes_since(sh.end), sh.is_night(), 0, kNoRole, 0});
+            }
+        }
+    }
 
     // Create worker state (tracking hours + last shift end)
     std::vector<WorkerState> workers;
@@ -84,68 +173,580 @@ ScheduleResult build_schedule(const InputModel& input, const EngineOptions& opt)
     for (const auto& s : input.staff) {
         WorkerState ws;
         ws.staff = &s;
-        ws.assigned_hours = Hours{0};
-        ws.last_end.reset();
         workers.push_back(ws);
     }
+    {
+        std::vector<std::uint32_t> by_id(workers.size());
+        for (std::uint32_t w = 0; w < by_id.size(); ++w) by_id[w] = w;
+        if (opt.tie_seed == 0) {
+            std::sort(by_id.begin(), by_id.end(), [&](std::uint32_t a, std::uint32_t b) {
+                return workers[a].staff->id != workers[b].staff->id ? workers[a].staff->id < workers[b].staff->id : a < b;
+            });
+        } else {
+            // Seeded tie-breaking: a random staff order replaces id order, and shifts that start
+            // together are taken in random order (start order, and so rest checks, are kept)
+            SplitMix64 rng(opt.tie_seed);
+            rng.shuffle(by_id.begin(), by_id.end());
+            for (size_t i = 0; i < eshifts.size();) {
+                size_t j = i + 1;
+                while (j < eshifts.size() && eshifts[j].start == eshifts[i].start) ++j;
+                rng.shuffle(eshifts.begin() + static_cast<std::ptrdiff_t>(i), eshifts.begin() + static_cast<std::ptrdiff_t>(j));
+                i = j;
+            }
+        }
+        for (std::uint32_t r = 0; r < by_id.size(); ++r) workers[by_id[r]].id_rank = r;
+    }
 
-    // Scheduling loop (One assignment per unique shift)
-    for (const auto& sh : shifts) {
-        Assignment asg;
-        asg.shift_id = sh.id;
+    // Hard constraints and soft terms selected by the rules, resolved to bits once
+    const ConstraintSelection selection = select_constraints(input.rules);
+    const bool fairness_on = opt.fairness_on && selection.fairness;
+    const bool preferences_on = opt.respect_preferences && selection.preferences;
 
-        // Build candidate list
-        std::vector<WorkerState*> candidates;
-        candidates.reserve(workers.size());
+    // Eligibility over the shifts in processing order (shift position = kernel position):
+    // interned roles and skills, local days and availability, so the filter compares no strings
+    std::vector<std::uint32_t> kernel_shifts(eshifts.size());
+    for (size_t i = 0; i < eshifts.size(); ++i) kernel_shifts[i] = static_cast<std::uint32_t>(eshifts[i].src - input.shifts.data());
+    const EligibilityKernel kernel(input, kernel_shifts, selection.hard);
+    const ConstraintSet hard = kernel.hard();
+    const std::uint32_t n_roles = kernel.role_count();
+    const std::int32_t n_days = kernel.day_count();
+    for (size_t w = 0; w < workers.size(); ++w) workers[w].role = kernel.staff_role(w);
+    if (!eshifts.empty()) {
+        const int week0 = kernel.first_day() - (weekday_from_days(kernel.first_day()) + 6) % 7; // Monday on or before
+        const CivilDate c = civil_from_days(week0);
+        result.week_start = DateStamp{c.y, c.m, c.d};
+        for (size_t i = 0; i < eshifts.size(); ++i) {
+            EngineShift& sh = eshifts[i];
+            sh.role = kernel.shift_role(i);
+            sh.week = static_cast<std::int32_t>(floor_div(kernel.first_day() + kernel.shift_day(i) - week0, 7));
+            result.week_count = std::max(result.week_count, static_cast<size_t>(std::max(sh.week, 0)) + 1);
+        }
+    }
+
+    // consecutive_days: a bitset of worked days per worker
+    const size_t day_words = kernel.day_words();
+    std::vector<std::uint64_t> worked_days;
+    if (hard & constraint::consecutive_days) worked_days.assign(workers.size() * day_words, 0);
+
+    // Scarcity order. Candidates per required slot are estimated from role, availability and
+    // skills only (not hours or rest). Shifts with no more candidates than slots go first,
+    // scarcest first, since they need every one of them; the rest keep start order, with the
+    // scarcest first among shifts that start together.
+    std::vector<std::uint32_t> process_order;
+    if (opt.shift_order == ShiftOrder::Scarcity && !eshifts.empty()) {
+        std::vector<std::vector<std::uint32_t>> members(n_roles);
+        for (std::uint32_t w = 0; w < workers.size(); ++w) members[workers[w].role].push_back(w);
 
-        for (auto& ws : workers) {
-            const Staff* s = ws.staff;
-            if (!role_ok(*s, sh)) continue;
-            if (!available_on(*s, sh.day())) continue;
-            if (!legal_hours_ok(ws, *s, sh)) continue;
-            if (!has_rest(ws, *s, sh)) continue;
-            candidates.push_back(&ws);
+        // Staff off per (role, day)
+        std::vector<std::int32_t> off(static_cast<size_t>(n_roles) * static_cast<size_t>(n_days), 0);
+        for (size_t w = 0; w < workers.size(); ++w) {
+            if (workers[w].staff->availability.empty()) continue;
+            for (std::int32_t d = 0; d < n_days; ++d) {
+                if (!kernel.available(w, d)) ++off[static_cast<size_t>(workers[w].role) * static_cast<size_t>(n_days) + static_cast<size_t>(d)];
+            }
         }
 
-        if (candidates.empty()) {
-            std::ostringstream oss;
-            oss << "No eligible staff for shift " << sh.id << " (" << sh.name << ")";
-            result.warnings.push_back(oss.str());
-            result.assignments.push_back(std::move(asg));
-            continue;
+        std::vector<double> supply(eshifts.size());
+        for (size_t i = 0; i < eshifts.size(); ++i) {
+            const EngineShift& sh = eshifts[i];
+            const int required = sh.src->required_count;
+            if (required <= 0) {
+                supply[i] = INT32_MAX; // nothing to staff
+                continue;
+            }
+            std::int32_t eligible = 0;
+            if (sh.role == kNoRole) {
+                eligible = 0;
+            } else if ((hard & constraint::skills) && !sh.src->req_skills.empty()) {
+                for (std::uint32_t w : members[sh.role]) eligible += kernel.available(w, kernel.shift_day(i)) && kernel.skills_ok(w, i);
+            } else {
+                eligible = static_cast<std::int32_t>(members[sh.role].size()) -
+                           off[static_cast<size_t>(sh.role) * static_cast<size_t>(n_days) + static_cast<size_t>(kernel.shift_day(i))];
+            }
+            supply[i] = static_cast<double>(eligible) / required;
         }
 
-        // Sort candidates fairness (fewest hours) then preferences then ID
-        std::sort(candidates.begin(), candidates.end(),
-                  [&](const WorkerState* a, const WorkerState* b) {
-                      if (opt.fairness_on && a->assigned_hours != b->assigned_hours) {
-                          return a->assigned_hours < b->assigned_hours;
-                      }
-                      if (opt.respect_preferences) {
-                          int pa = preference_penalty(*a->staff, sh);
-                          int pb = preference_penalty(*b->staff, sh);
-                          if (pa != pb) return pa < pb;
-                      }
-                      return a->staff->id < b->staff->id;
-                  });
+        process_order.resize(eshifts.size());
+        for (std::uint32_t i = 0; i < process_order.size(); ++i) process_order[i] = i;
+        std::stable_sort(process_order.begin(), process_order.end(), [&](std::uint32_t a, std::uint32_t b) {
+            const bool critical_a = supply[a] <= 1.0;
+            const bool critical_b = supply[b] <= 1.0;
+            if (critical_a != critical_b) return critical_a;
+            if (critical_a && supply[a] != supply[b]) return supply[a] < supply[b];
+            if (eshifts[a].start != eshifts[b].start) return eshifts[a].start < eshifts[b].start;
+            return supply[a] < supply[b];
+        });
+    }
+
+    // rest: every worker's assigned intervals, sized once for all slots (no growth in the loop)
+    size_t slot_total = 0;
+    for (const auto& sh : eshifts) slot_total += static_cast<size_t>(std::max<int>(sh.src->required_count, 0));
+    WorkerTimelines timelines;
+    if (hard & constraint::rest) timelines.reset(workers.size(), slot_total);
 
-        int need = sh.required_count;
-        for (auto* ws : candidates) {
-            if (need == 0) break;
-            asg.staff_ids.push_back(ws->staff->id);
-            ws->assigned_hours += sh.duration();
-            ws->last_end = sh.end;
-            --need;
+    // The fused filter: every selected constraint, cheapest first, no strings or indirection
+    auto first_failure = [&](const WorkerState& ws, std::uint32_t pos) {
+        const size_t w = static_cast<size_t>(&ws - workers.data());
+        if (!kernel.role_ok(w, pos)) return Reject::Role;
+        if (!kernel.available(w, kernel.shift_day(pos))) return Reject::Availability;
+        if (!kernel.hours_ok(w, ws.assigned_minutes, pos)) return Reject::Hours;
+        if ((hard & constraint::rest) && !has_rest(timelines, w, *ws.staff, eshifts[pos])) return Reject::Rest;
+        if ((hard & constraint::consecutive_days) &&
+            !kernel.consecutive_ok(&worked_days[w * day_words], w, pos)) return Reject::ConsecutiveDays;
+        if (!kernel.skills_ok(w, pos)) return Reject::Skills;
+        return Reject::None;
+    };
+
+    // Preference penalties: the caller's table (checked by the caller; hashing the staff on
+    // every run would cost more than the lookups save), else a fresh one
+    PenaltyTable own_penalties;
+    const PenaltyTable* penalties = opt.penalties;
+    assert(!penalties || penalties->built_for(input));
+    if (!penalties) {
+        own_penalties = build_penalty_table(input);
+        penalties = &own_penalties;
+    }
+    for (auto& sh : eshifts) sh.unit = penalties->column_of(sh.src->name);
+    auto penalty_of = [&](const WorkerState* ws, const EngineShift& sh) {
+        return penalties->penalty(static_cast<size_t>(ws - workers.data()), sh.unit, sh.night);
+    };
+
+    // Fairness heaps: one min-heap of worker indices per role, keyed by (assigned minutes, id).
+    // With fairness on and no diagnostics the loop pops candidates in ranking order and stops
+    // once the shift is covered; otherwise it scans every worker and sorts the eligible ones.
+    const bool use_heap = fairness_on && !diag_on;
+    auto heap_after = [&](std::uint32_t a, std::uint32_t b) {
+        const WorkerState& x = workers[a];
+        const WorkerState& y = workers[b];
+        return x.assigned_minutes != y.assigned_minutes ? x.assigned_minutes > y.assigned_minutes
+                                                        : x.id_rank > y.id_rank;
+    };
+    std::vector<std::vector<std::uint32_t>> heaps;
+    Minute shortest_shift = INT32_MAX;
+    for (const auto& sh : eshifts) shortest_shift = std::min(shortest_shift, sh.duration());
+    if (use_heap) {
+        heaps.resize(n_roles);
+        for (std::uint32_t w = 0; w < workers.size(); ++w) heaps[workers[w].role].push_back(w);
+        for (auto& h : heaps) std::make_heap(h.begin(), h.end(), heap_after);
+    }
+
+    // Per-run scratch. Every temporary the loop needs lives in one arena sized up front,
+    // so the steady-state loop performs no heap allocations; strings are built afterwards.
+    const size_t n_shifts = eshifts.size();
+    const size_t arena_bytes = workers.size() * (sizeof(WorkerState*) + sizeof(std::uint32_t)) +
+                               n_shifts * sizeof(Shortfall) +
+                               (diag_on ? n_shifts * sizeof(DiagCounts) : 0) + 8 * alignof(std::max_align_t);
+    std::pmr::monotonic_buffer_resource arena(arena_bytes);
+
+    std::pmr::vector<WorkerState*> candidates(&arena);  // reused for every shift
+    std::pmr::vector<std::uint32_t> popped(&arena);     // heap path: workers taken out for this shift
+    std::pmr::vector<Shortfall> shortfalls(&arena);
+    std::pmr::vector<DiagCounts> diags(&arena);
+    candidates.reserve(workers.size());
+    if (use_heap) popped.reserve(workers.size());
+    shortfalls.reserve(n_shifts);
+    if (diag_on) diags.resize(n_shifts);
+
+    // Per-staff aggregates, indexed like input.staff
+    result.staff_totals.assign(workers.size(), StaffTotals{});
+    result.week_minutes.assign(workers.size() * result.week_count, 0);
+
+    // The flat result is written directly (sizes known up front)
+    result.shift_index.reserve(n_shifts);
+    result.staff_offsets.reserve(n_shifts + 1);
+    result.staff_index.reserve(slot_total);
+    result.staff_offsets.push_back(0);
+
+    // Everyone taken off a heap for the current shift goes back with their (possibly new) minutes
+    auto restore_popped = [&](std::uint32_t role) {
+        if (role == kNoRole) return;
+        auto& heap = heaps[role];
+        for (std::uint32_t w : popped) {
+            heap.push_back(w);
+            std::push_heap(heap.begin(), heap.end(), heap_after);
         }
+    };
+
+    // Scheduling loop (One assignment per unique shift), instantiated per policy so the
+    // option checks below fold away for the common combinations
+    auto schedule_loop = [&](auto policy) {
+        for (std::uint32_t step = 0; step < n_shifts; ++step) {
+            const std::uint32_t pos = process_order.empty() ? step : process_order[step];
+            const EngineShift& sh = eshifts[pos];
+            result.shift_index.push_back(static_cast<std::uint32_t>(sh.src - input.shifts.data()));
 
-        if (need > 0) {
-            std::ostringstream oss;
-            oss << "Coverage short by " << need << " for shift " << sh.id;
-            result.warnings.push_back(oss.str());
+            // Build candidate list
+            candidates.clear();
+
+            // Ranking: fewest minutes (if fairness), then preference penalty, then id
+            auto ranks_before = [&](const WorkerState* a, const WorkerState* b) {
+                if (policy.fairness() && a->assigned_minutes != b->assigned_minutes) {
+                    return a->assigned_minutes < b->assigned_minutes;
+                }
+                if (policy.preferences()) {
+                    int pa = penalty_of(a, sh);
+                    int pb = penalty_of(b, sh);
+                    if (pa != pb) return pa < pb;
+                }
+                return a->id_rank < b->id_rank;
+            };
+
+            DiagCounts diag{};
+            size_t examined = 0;
+            if (policy.heap_path()) {
+                // Pop groups of equal minutes until the shift is covered (at least one candidate is
+                // still needed to tell "nobody eligible" apart from a zero requirement)
+                ScopedTimer timer(prof, Phase::CandidateFilter);
+                popped.clear();
+                size_t retired = 0;
+                const size_t want = static_cast<size_t>(std::max<int>(sh.src->required_count, 1));
+                if (sh.role != kNoRole) {
+                    auto& heap = heaps[sh.role];
+                    while (candidates.size() < want && !heap.empty()) {
+                        // Within a group workers come off in id order, so once enough of them have
+                        // no penalty the rest of the group cannot rank ahead and stays on the heap
+                        const Minute group_minutes = workers[heap.front()].assigned_minutes;
+                        const size_t group_begin = candidates.size();
+                        size_t unpenalized = 0;
+                        while (!heap.empty() && workers[heap.front()].assigned_minutes == group_minutes &&
+                               group_begin + unpenalized < want) {
+                            std::pop_heap(heap.begin(), heap.end(), heap_after);
+                            const std::uint32_t w = heap.back();
+                            heap.pop_back();
+                            WorkerState& ws = workers[w];
+                            if ((hard & constraint::weekly_hours) &&
+                                Minute{ws.staff->max_weekly_hours} * 60 - ws.assigned_minutes < shortest_shift) {
+                                ++retired;
+                                continue; // can never fit another shift: leaves the heap for good
+                            }
+                            popped.push_back(w);
+                            if (first_failure(ws, pos) == Reject::None) {
+                                candidates.push_back(&ws);
+                                if (!policy.preferences() || penalty_of(&ws, sh) == 0) ++unpenalized;
+                            }
+                        }
+                        if (policy.preferences()) {
+                            std::sort(candidates.begin() + static_cast<std::ptrdiff_t>(group_begin), candidates.end(),
+                                      ranks_before);
+                        }
+                    }
+                }
+                examined = popped.size() + retired;
+            } else {
+                ScopedTimer timer(prof, Phase::CandidateFilter);
+                for (auto& ws : workers) {
+                    const Reject why = first_failure(ws, pos);
+                    if (why == Reject::None) {
+                        candidates.push_back(&ws);
+                    } else if (policy.diagnostics()) {
+                        switch (why) {
+                            case Reject::Role:            ++diag.rejected_role; break;
+                            case Reject::Availability:    ++diag.rejected_availability; break;
+                            case Reject::Hours:           ++diag.rejected_hours; break;
+                            case Reject::Rest:            ++diag.rejected_rest; break;
+                            case Reject::ConsecutiveDays: ++diag.rejected_consecutive_days; break;
+                            case Reject::Skills:          ++diag.rejected_skills; break;
+                            case Reject::None:            break;
+                        }
+                    }
+                }
+                examined = workers.size();
+            }
+
+            if (prof) {
+                prof->count(Counter::CandidatesExamined, examined);
+                prof->count(Counter::CandidatesEligible, candidates.size());
+            }
+
+            if (policy.diagnostics()) {
+                diag.eligible = static_cast<int>(candidates.size());
+                diags[pos] = diag;
+            }
+
+            if (candidates.empty()) {
+                if (prof) prof->count(Counter::CoverageShort, static_cast<std::uint64_t>(sh.src->required_count));
+                shortfalls.push_back(Shortfall{pos, sh.src->required_count, true});
+                result.staff_offsets.push_back(static_cast<std::uint32_t>(result.staff_index.size()));
+                if (policy.heap_path()) restore_popped(sh.role);
+                continue;
+            }
+
+            if (!policy.heap_path()) {
+                ScopedTimer rank_timer(prof, Phase::CandidateRank);
+                std::sort(candidates.begin(), candidates.end(), ranks_before);
+            }
+
+            int need = sh.src->required_count;
+            for (auto* ws : candidates) {
+                if (need <= 0) break;
+                const auto w = static_cast<std::uint32_t>(ws - workers.data());
+                result.staff_index.push_back(w);
+                ws->assigned_minutes += sh.duration();
+                if (hard & constraint::rest) timelines.insert(w, sh.start, sh.end);
+                if (hard & constraint::consecutive_days) kernel.mark_day(&worked_days[w * day_words], pos);
+
+                StaffTotals& tot = result.staff_totals[w];
+                tot.minutes += sh.duration();
+                tot.shifts += 1;
+                tot.nights += sh.night;
+                tot.preference_violations += penalty_of(ws, sh) > 0;
+                if (sh.week >= 0) result.week_minutes[w * result.week_count + static_cast<size_t>(sh.week)] += sh.duration();
+                --need;
+            }
+            result.staff_offsets.push_back(static_cast<std::uint32_t>(result.staff_index.size()));
+
+            if (policy.heap_path()) restore_popped(sh.role);
+
+            if (prof) prof->count(Counter::CoverageShort, static_cast<std::uint64_t>(std::max(need, 0)));
+            if (need > 0) shortfalls.push_back(Shortfall{pos, need, false});
+        }
+    };
+
+    if (opt.runtime_dispatch || diag_on) {
+        schedule_loop(RuntimePolicy{fairness_on, preferences_on, diag_on});
+    } else if (fairness_on) {
+        if (preferences_on) schedule_loop(StaticPolicy<true, true>{});
+        else                schedule_loop(StaticPolicy<true, false>{});
+    } else {
+        if (preferences_on) schedule_loop(StaticPolicy<false, true>{});
+        else                schedule_loop(StaticPolicy<false, false>{});
+    }
+
+    // Out-of-order runs wrote the entries in staffing order: list them in start order again
+    if (!process_order.empty()) {
+        std::vector<std::uint32_t> step_of(n_shifts);
+        for (std::uint32_t step = 0; step < n_shifts; ++step) step_of[process_order[step]] = step;
+        std::vector<std::uint32_t> shift_index(n_shifts), staff_offsets, staff_index;
+        staff_offsets.reserve(n_shifts + 1);
+        staff_index.reserve(result.staff_index.size());
+        staff_offsets.push_back(0);
+        for (std::uint32_t pos = 0; pos < n_shifts; ++pos) {
+            const std::uint32_t step = step_of[pos];
+            shift_index[pos] = result.shift_index[step];
+            staff_index.insert(staff_index.end(), result.staff_begin(step), result.staff_end(step));
+            staff_offsets.push_back(static_cast<std::uint32_t>(staff_index.size()));
+        }
+        result.shift_index = std::move(shift_index);
+        result.staff_offsets = std::move(staff_offsets);
+        result.staff_index = std::move(staff_index);
+        std::sort(shortfalls.begin(), shortfalls.end(),
+                  [](const Shortfall& a, const Shortfall& b) { return a.pos < b.pos; });
+    }
+
+    // Install new staff lists (entries in start order) from a post-pass, then recount the
+    // totals and open slots. Zero-requirement entries are kept, and a shift still empty keeps
+    // the greedy pass's "nobody eligible" verdict.
+    auto replace_assignments = [&](std::vector<std::uint32_t> staff_offsets, std::vector<std::uint32_t> staff_index) {
+        result.staff_offsets = std::move(staff_offsets);
+        result.staff_index = std::move(staff_index);
+
+        result.staff_totals.assign(workers.size(), StaffTotals{});
+        result.week_minutes.assign(workers.size() * result.week_count, 0);
+        for (std::uint32_t pos = 0; pos < n_shifts; ++pos) {
+            const EngineShift& sh = eshifts[pos];
+            for (const std::uint32_t* p = result.staff_begin(pos); p != result.staff_end(pos); ++p) {
+                StaffTotals& tot = result.staff_totals[*p];
+                tot.minutes += sh.duration();
+                tot.shifts += 1;
+                tot.nights += sh.night;
+                tot.preference_violations += penalty_of(&workers[*p], sh) > 0;
+                if (sh.week >= 0) result.week_minutes[*p * result.week_count + static_cast<size_t>(sh.week)] += sh.duration();
+            }
+        }
+
+        std::vector<std::uint8_t> none_eligible(n_shifts, 0);
+        for (const auto& sf : shortfalls) none_eligible[sf.pos] = sf.none_eligible;
+        shortfalls.erase(std::remove_if(shortfalls.begin(), shortfalls.end(), [](const Shortfall& sf) { return sf.need > 0; }),
+                         shortfalls.end());
+        for (std::uint32_t pos = 0; pos < n_shifts; ++pos) {
+            const long open = eshifts[pos].src->required_count - static_cast<long>(result.staff_count(pos));
+            if (open > 0) {
+                shortfalls.push_back(Shortfall{pos, static_cast<int>(open), none_eligible[pos] && result.staff_count(pos) == 0});
+            }
+        }
+        std::stable_sort(shortfalls.begin(), shortfalls.end(),
+                         [](const Shortfall& a, const Shortfall& b) { return a.pos < b.pos; });
+    };
+
+    // Exact mode: each small enough role is searched with the greedy schedule as incumbent,
+    // which is only replaced by a strictly better one
+    if (opt.exact.enabled && n_shifts > 0) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(opt.exact.time_limit_ms);
+        const size_t max_staff = std::min<size_t>(opt.exact.max_staff, ExactUnit::kMaxStaff);
+        std::vector<std::vector<std::uint32_t>> members(n_roles), role_shifts(n_roles);
+        for (std::uint32_t w = 0; w < workers.size(); ++w) members[workers[w].role].push_back(w);
+        for (std::uint32_t pos = 0; pos < n_shifts; ++pos) {
+            if (eshifts[pos].role != kNoRole) role_shifts[eshifts[pos].role].push_back(pos);
+        }
+        auto open_slots = [&](std::uint32_t pos, size_t staffed) {
+            return std::max<long>(0, eshifts[pos].src->required_count - static_cast<long>(staffed));
+        };
+
+        std::vector<std::vector<std::uint32_t>> replaced(n_shifts); // new staff of improved shifts
+        std::vector<std::uint8_t> is_replaced(n_shifts, 0);
+        for (std::uint32_t r = 0; r < n_roles; ++r) {
+            const auto& staff = members[r];
+            const auto& shifts = role_shifts[r];
+            if (shifts.empty()) continue;
+            ExactComponent comp;
+            comp.role = workers[staff.front()].staff->role;
+            comp.staff = static_cast<std::uint32_t>(staff.size());
+            comp.shifts = static_cast<std::uint32_t>(shifts.size());
+            for (std::uint32_t pos : shifts) comp.greedy_shortfall += open_slots(pos, result.staff_count(pos));
+            comp.shortfall = comp.greedy_shortfall;
+            if (staff.size() > max_staff || shifts.size() > opt.exact.max_shifts) {
+                result.exact.push_back(comp);
+                continue;
+            }
+
+            // The role as an exact unit: worker b is staff[b], shift i is shifts[i]
+            ExactUnit unit;
+            unit.days = n_days;
+            unit.fairness = fairness_on;
+            unit.preferences = preferences_on;
+            for (std::uint32_t w : staff) {
+                const Staff& s = *workers[w].staff;
+                ExactUnit::Worker uw;
+                if (hard & constraint::weekly_hours) uw.cap = Minute{s.max_weekly_hours} * 60;
+                if (hard & constraint::rest) uw.rest = Minute{s.min_rest} * 60;
+                if (hard & constraint::consecutive_days) uw.max_consecutive = s.max_consecutive_days;
+                unit.workers.push_back(uw);
+            }
+            std::vector<std::uint64_t> incumbent;
+            for (std::uint32_t pos : shifts) {
+                const EngineShift& sh = eshifts[pos];
+                ExactUnit::Shift us;
+                us.start = sh.start;
+                us.end = sh.end;
+                us.day = kernel.shift_day(pos);
+                us.required = std::max<int>(sh.src->required_count, 0);
+                for (std::uint32_t b = 0; b < staff.size(); ++b) {
+                    const std::uint32_t w = staff[b];
+                    if (kernel.static_ok(w, pos)) us.eligible |= std::uint64_t{1} << b;
+                    if (penalty_of(&workers[w], sh) > 0) us.penalized |= std::uint64_t{1} << b;
+                }
+                unit.shifts.push_back(us);
+
+                std::uint64_t mask = 0;
+                for (const std::uint32_t* p = result.staff_begin(pos); p != result.staff_end(pos); ++p) {
+                    mask |= std::uint64_t{1} << (std::find(staff.begin(), staff.end(), *p) - staff.begin());
+                }
+                incumbent.push_back(mask);
+            }
+
+            // Roles still to search share the time left equally
+            size_t to_search = 0;
+            for (std::uint32_t q = r; q < n_roles; ++q) {
+                to_search += !role_shifts[q].empty() && members[q].size() <= max_staff &&
+                             role_shifts[q].size() <= opt.exact.max_shifts;
+            }
+            const auto now = std::chrono::steady_clock::now();
+            ExactLimits limits;
+            limits.nodes = opt.exact.node_limit;
+            limits.deadline = now + (deadline > now ? (deadline - now) / static_cast<int>(to_search) : deadline - now);
+            const ExactSolution sol = solve_exact(unit, incumbent, limits);
+            comp.searched = true;
+            comp.optimal = sol.optimal;
+            comp.improved = sol.improved;
+            comp.nodes = sol.nodes;
+            if (sol.improved) {
+                comp.shortfall = 0;
+                for (size_t i = 0; i < shifts.size(); ++i) {
+                    const std::uint32_t pos = shifts[i];
+                    is_replaced[pos] = 1;
+                    for (std::uint64_t bits = sol.staffed[i]; bits; bits &= bits - 1) {
+                        replaced[pos].push_back(staff[static_cast<size_t>(__builtin_ctzll(bits))]);
+                    }
+                    comp.shortfall += open_slots(pos, replaced[pos].size());
+                }
+            }
+            result.exact.push_back(comp);
         }
 
-        result.assignments.push_back(std::move(asg));
+        // Rewrite the improved roles' entries
+        if (std::find(is_replaced.begin(), is_replaced.end(), 1) != is_replaced.end()) {
+            std::vector<std::uint32_t> staff_offsets, staff_index;
+            staff_offsets.reserve(n_shifts + 1);
+            staff_index.reserve(result.staff_index.size());
+            staff_offsets.push_back(0);
+            for (std::uint32_t pos = 0; pos < n_shifts; ++pos) {
+                if (is_replaced[pos]) staff_index.insert(staff_index.end(), replaced[pos].begin(), replaced[pos].end());
+                else staff_index.insert(staff_index.end(), result.staff_begin(pos), result.staff_end(pos));
+                staff_offsets.push_back(static_cast<std::uint32_t>(staff_index.size()));
+            }
+            replace_assignments(std::move(staff_offsets), std::move(staff_index));
+        }
+    }
+
+    // Anneal mode: simulated annealing from the schedule so far, kept only if it scores lower
+    if ((opt.anneal.time_budget_ms > 0 || opt.anneal.max_moves > 0) && n_shifts > 0) {
+        AnnealOptions anneal = opt.anneal;
+        ObjectiveWeights weights = anneal.weights.value_or(input.rules.objective);
+        if (!fairness_on) weights.hours_variance = 0;
+        if (!preferences_on) weights.preference = 0;
+        anneal.weights = weights;
+        AnnealOutcome out = anneal_assignments(input, result, *penalties, anneal);
+        result.anneal = out.stats;
+        if (out.improved) {
+            replace_assignments(std::move(out.staff_offsets), std::move(out.staff_index));
+            // Exact mode's per-role shortfalls describe the schedule it handed over
+            if (!result.exact.empty()) {
+                std::unordered_map<std::string_view, ExactComponent*> comp_of;
+                for (auto& comp : result.exact) {
+                    comp.shortfall = 0;
+                    comp_of.emplace(comp.role, &comp);
+                }
+                for (std::uint32_t pos = 0; pos < n_shifts; ++pos) {
+                    auto it = comp_of.find(eshifts[pos].src->req_role);
+                    if (it == comp_of.end()) continue;
+                    it->second->shortfall += std::max<long>(0, eshifts[pos].src->required_count - static_cast<long>(result.staff_count(pos)));
+                }
+            }
+        }
+    }
+
+    // Messages are formatted outside the loop
+    result.warnings.reserve(selection.unknown.size() + shortfalls.size());
+    for (const auto& name : selection.unknown) {
+        result.warnings.push_back("Unknown constraint '" + name + "' ignored");
+    }
+    for (const auto& sf : shortfalls) {
+        const Shifts& src = *eshifts[sf.pos].src;
+        std::ostringstream oss;
+        if (sf.none_eligible) {
+            oss << "No eligible staff for shift " << src.id << " (" << src.name << ")";
+        } else {
+            oss << "Coverage short by " << sf.need << " for shift " << src.id;
+        }
+        result.warnings.push_back(oss.str());
+    }
+
+    if (diag_on) {
+        result.diagnostics.resize(n_shifts);
+        for (size_t i = 0; i < n_shifts; ++i) {
+            ShiftDiagnostics& d = result.diagnostics[i];
+            d.shift_id = eshifts[i].src->id;
+            d.eligible = diags[i].eligible;
+            d.rejected_role = diags[i].rejected_role;
+            d.rejected_availability = diags[i].rejected_availability;
+            d.rejected_hours = diags[i].rejected_hours;
+            d.rejected_rest = diags[i].rejected_rest;
+            d.rejected_consecutive_days = diags[i].rejected_consecutive_days;
+            d.rejected_skills = diags[i].rejected_skills;
+        }
     }
 
     return result;
 }
+
+std::vector<Assignment> to_assignments(const InputModel& model, const ScheduleResult& result) {
+    std::vector<Assignment> out(result.shift_count());
+    for (size_t k = 0; k < out.size(); ++k) {
+        out[k].shift_id = model.shifts[result.shift_index[k]].id;
+        out[k].staff_ids.reserve(result.staff_count(k));
+        for (const std::uint32_t* p = result.staff_begin(k); p != result.staff_end(k); ++p) {
+            out[k].staff_ids.push_back(model.staff[*p].id);
+        }
+    }
+    return out;
+}
@@ -1,23 +1,169 @@
 #pragma once
 
 #include "model.hpp"
+#include <cstdint>
+#include <optional>
 #include <string>
 #include <vector>
 
+// Eligibility diagnostics are compiled in by default; build with -DHOS_DIAGNOSTICS=0 to strip them
+#ifndef HOS_DIAGNOSTICS
+#define HOS_DIAGNOSTICS 1
+#endif
+
+class Profiler; // profiler.hpp
+
+// Preference penalties by (staff, unit) plus a night penalty per staff, so ranking is a
+// table lookup. Build once per model with build_penalty_table and pass it through
+// EngineOptions::penalties to share it across runs on the same staff and units. Whoever
+// shares it checks that once (built_for, or knowing the staff list is unchanged); runs only
+// re-check it in debug builds.
+struct PenaltyTable {
+    static constexpr std::uint8_t kNightPenalty = 5; // avoid_nights staff on a night shift
+    static constexpr std::uint8_t kUnitPenalty = 1;  // unit outside the staff's preferred units
+
+    size_t staff_count = 0;
+    std::uint64_t staff_key = 0; // penalty_staff_key of the staff it was built for
+    std::unordered_map<std::string, std::uint32_t> unit_column; // last column: any other unit
+    size_t columns = 0;                                         // unit_column.size() + 1
+    std::vector<std::uint8_t> unit_penalty;                     // staff-major: staff * columns + column
+    std::vector<std::uint8_t> night_penalty;                    // per staff
+
+    std::uint32_t column_of(const std::string& unit) const {
+        auto it = unit_column.find(unit);
+        return it != unit_column.end() ? it->second : static_cast<std::uint32_t>(columns - 1);
+    }
+    int penalty(size_t staff, std::uint32_t column, bool night) const {
+        return unit_penalty[staff * columns + column] + (night ? night_penalty[staff] : 0);
+    }
+
+    // Same staff (ids and preferences, in order) and a column for every unit of the model
+    bool built_for(const InputModel& model) const;
+};
+
+// Hash of what the table reads from the staff list: ids, avoid_nights, preferred units
+std::uint64_t penalty_staff_key(const std::vector<Staff>& staff);
+
+PenaltyTable build_penalty_table(const InputModel& model);
+
+// Order in which shifts are staffed (the result is always listed in start order)
+enum class ShiftOrder : std::uint8_t {
+    Start,    // ascending start time
+    Scarcity, // fewest role/availability-eligible staff per required slot first
+};
+
+// Exact mode: after the greedy pass, every role small enough is searched by branch and bound
+// (exact.hpp) for strictly better coverage, then fairness, then preferences. Roles are
+// independent (staff have one role, shifts need one), so each is solved on its own.
+struct ExactOptions {
+    bool enabled = false;
+    std::uint32_t max_staff = 40;          // larger roles keep the greedy schedule (64 at most)
+    std::uint32_t max_shifts = 200;
+    std::uint64_t node_limit = 1'000'000;  // per role
+    std::uint32_t time_limit_ms = 500;     // whole run; roles past the deadline keep the greedy schedule
+};
+
+// Anneal mode: simulated annealing over the finished schedule (anneal.hpp). Moves reassign
+// or exchange staff between slots of one role and always keep the hard constraints; the
+// schedule is only replaced if its score_schedule total went down.
+struct AnnealOptions {
+    std::uint32_t time_budget_ms = 0; // 0: off
+    std::uint64_t max_moves = 0;      // also stop after this many moves (0: the time budget only)
+    std::uint64_t seed = 1;
+    std::optional<ObjectiveWeights> weights; // default: the input's Rules::objective; terms of
+                                             // soft constraints that are off are not counted
+};
+
 struct EngineOptions {
     bool fairness_on        = true;  // prefer staff with fewer hours
     bool respect_preferences = true; // avoid nights / non-preferred units when possible
+    bool diagnostics        = false; // count rejection reasons per shift (needs HOS_DIAGNOSTICS)
+    Profiler* profiler      = nullptr; // optional phase timers and counters
+    const PenaltyTable* penalties = nullptr; // must be built_for the model; null: built per run
+    bool runtime_dispatch   = false; // benchmark baseline: one loop that branches on the options
+    std::uint64_t tie_seed  = 0;     // 0: ties go by staff id; else a seeded random staff order and
+                                     // a shuffled order among shifts with the same start (portfolio passes)
+    ShiftOrder shift_order  = ShiftOrder::Start;
+    ExactOptions exact;
+    AnnealOptions anneal;
 };
 
+// One shift with the ids of its staff (see to_assignments)
 struct Assignment {
     std::string shift_id;
     std::vector<std::string> staff_ids;
 };
 
+// Why staff were filtered out for one shift (each staff counted against the first failed check).
+// Counted during the greedy pass; exact and anneal mode do not update them.
+struct ShiftDiagnostics {
+    std::string shift_id;
+    int eligible = 0;
+    int rejected_role = 0;
+    int rejected_availability = 0;
+    int rejected_hours = 0;
+    int rejected_rest = 0;
+    int rejected_consecutive_days = 0;
+    int rejected_skills = 0;
+};
+
+// What one staff member ended up with (exact minutes)
+struct StaffTotals {
+    std::int32_t minutes = 0;               // assigned time over the whole horizon
+    std::int32_t shifts = 0;
+    std::int32_t nights = 0;                // shifts with Shifts::is_night()
+    std::int32_t preference_violations = 0; // shifts that break avoid_nights or the preferred units
+};
+
+// What exact mode did for one role
+struct ExactComponent {
+    std::string role;
+    std::uint32_t staff = 0;
+    std::uint32_t shifts = 0;
+    bool searched = false;      // within the size limits
+    bool optimal = false;       // search finished: no better schedule exists for the role
+    bool improved = false;      // the greedy schedule was replaced
+    std::uint64_t nodes = 0;
+    long greedy_shortfall = 0;  // required slots the greedy pass left open
+    long shortfall = 0;         // in the final schedule (after anneal mode too)
+};
+
+// What anneal mode did
+struct AnnealStats {
+    std::uint64_t moves = 0;     // proposed
+    std::uint64_t accepted = 0;
+    double initial_score = 0;    // of the schedule it started from
+    double final_score = 0;      // of the schedule kept (never above initial_score)
+    double seconds = 0;
+};
+
 struct ScheduleResult {
-    std::vector<Assignment> assignments;
+    // Flat assignments, one entry per unique shift in start order. The staff of
+    // entry k are staff_index[staff_offsets[k] .. staff_offsets[k + 1]).
+    std::vector<std::uint32_t> shift_index;   // into InputModel::shifts
+    std::vector<std::uint32_t> staff_offsets; // shift_count() + 1 entries
+    std::vector<std::uint32_t> staff_index;   // into InputModel::staff
+
+    // Per-staff aggregates, indexed like InputModel::staff. Week w covers the seven days
+    // from week_start + 7w; week_minutes is staff-major (staff * week_count + w).
+    std::vector<StaffTotals> staff_totals;
+    std::vector<std::int32_t> week_minutes;
+    size_t week_count = 0;
+    DateStamp week_start{}; // Monday on or before the first shift
     std::vector<std::string> warnings;
+    std::vector<ShiftDiagnostics> diagnostics; // Filled only when EngineOptions::diagnostics is set
+    std::vector<ExactComponent> exact;         // Filled only in exact mode, one per role with shifts
+    AnnealStats anneal;                        // Filled only in anneal mode
+
+    size_t shift_count() const { return shift_index.size(); }
+    size_t staff_count(size_t k) const { return staff_offsets[k + 1] - staff_offsets[k]; }
+    const std::uint32_t* staff_begin(size_t k) const { return staff_index.data() + staff_offsets[k]; }
+    const std::uint32_t* staff_end(size_t k) const { return staff_index.data() + staff_offsets[k + 1]; }
+    std::int32_t week_minutes_of(size_t staff, size_t week) const { return week_minutes[staff * week_count + week]; }
 };
 
 // Build a schedule from parsed input model
 ScheduleResult build_schedule(const InputModel& model, const EngineOptions& opt = EngineOptions{});
+
+// Assignment objects with ids copied from the model, for callers that want strings
+std::vector<Assignment> to_assignments(const InputModel& model, const ScheduleResult& result);
@@ -0,0 +1,386 @@
+#include "exact.hpp"
+#include "eligibility.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+using Minute = std::int32_t;
+
+// Bit counts on staff masks (C++17, so the GCC/Clang builtins rather than <bit>)
+int count_staff(std::uint64_t mask) { return __builtin_popcountll(mask); }
+int lowest_staff(std::uint64_t mask) { return __builtin_ctzll(mask); }
+
+long deficit_of(std::int32_t required, std::uint64_t mask) {
+    return std::max<long>(0, required - count_staff(mask));
+}
+
+class Search {
+public:
+    Search(const ExactUnit& unit, const ExactLimits& limits) : u_(unit), limits_(limits) {
+        const size_t n = unit.shifts.size();
+        const size_t k = unit.workers.size();
+
+        // Later shifts each worker could not also take after shift i: closer than their rest.
+        // Starts are sorted, so the gaps only grow and the scan stops at the longest rest.
+        std::int64_t max_rest = INT32_MIN;
+        for (const auto& w : unit.workers) max_rest = std::max<std::int64_t>(max_rest, w.rest);
+        conflicts_.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = i + 1; j < n; ++j) {
+                const std::int64_t gap = std::int64_t{unit.shifts[j].start} - unit.shifts[i].end;
+                if (gap >= max_rest) break;
+                std::uint64_t mask = 0;
+                for (size_t w = 0; w < k; ++w) {
+                    if (gap < unit.workers[w].rest) mask |= std::uint64_t{1} << w;
+                }
+                if (mask) conflicts_[i].push_back({static_cast<std::uint32_t>(j), mask});
+            }
+        }
+
+        suffix_required_.assign(n + 1, 0);
+        suffix_min_duration_.assign(n + 1, INT32_MAX);
+        suffix_max_duration_.assign(n + 1, 0);
+        suffix_demand_.assign(n + 1, 0);
+        for (size_t i = n; i-- > 0;) {
+            const auto& sh = unit.shifts[i];
+            suffix_required_[i] = suffix_required_[i + 1] + sh.required;
+            suffix_min_duration_[i] = suffix_min_duration_[i + 1];
+            if (sh.required > 0) suffix_min_duration_[i] = std::min(suffix_min_duration_[i], sh.duration());
+            suffix_max_duration_[i] = std::max(suffix_max_duration_[i + 1], sh.duration());
+            suffix_demand_[i] = suffix_demand_[i + 1] + std::int64_t{sh.required} * sh.duration();
+        }
+
+        day_words_ = (static_cast<size_t>(std::max(unit.days, 0)) + 63) / 64;
+        worked_.assign(k * day_words_, 0);
+        minutes_.assign(k, 0);
+        all_capped_ = true;
+        capacity_left_ = 0;
+        for (const auto& w : unit.workers) {
+            all_capped_ = all_capped_ && w.cap != INT32_MAX;
+            capacity_left_ += w.cap;
+        }
+        dom_.resize(n);
+        future_deficit_ = 0;
+        for (size_t i = 0; i < n; ++i) {
+            dom_[i] = unit.shifts[i].eligible;
+            future_deficit_ += deficit_of(unit.shifts[i].required, dom_[i]);
+        }
+        staffed_.assign(n, 0);
+        candidates_.assign(n * ExactUnit::kMaxStaff, 0);
+
+        // Staff with the same limits, eligibility and preferences fall in one class
+        class_.assign(k, 0);
+        for (size_t a = 0; a < k; ++a) {
+            class_[a] = static_cast<std::uint8_t>(a);
+            for (size_t b = 0; b < a; ++b) {
+                if (class_[b] == b && same_profile(a, b)) {
+                    class_[a] = static_cast<std::uint8_t>(b);
+                    break;
+                }
+            }
+        }
+    }
+
+    void run(const std::vector<std::uint64_t>& incumbent, ExactSolution& out) {
+        best_ = evaluate_exact(u_, incumbent);
+        best_staffed_ = incumbent;
+        out.incumbent = best_;
+        shift(0);
+        out.staffed = std::move(best_staffed_);
+        out.objective = best_;
+        out.nodes = nodes_;
+        out.optimal = !stopped_;
+        out.improved = out.objective < out.incumbent;
+    }
+
+private:
+    struct Removal {
+        std::uint32_t shift;
+        std::uint64_t bits;
+    };
+
+    // Take worker bits out of a later shift's mask (undone by backtrack)
+    void remove(std::uint32_t j, std::uint64_t bits) {
+        bits &= dom_[j];
+        if (!bits) return;
+        const long before = deficit_of(u_.shifts[j].required, dom_[j]);
+        dom_[j] &= ~bits;
+        future_deficit_ += deficit_of(u_.shifts[j].required, dom_[j]) - before;
+        trail_.push_back({j, bits});
+    }
+
+    void backtrack(size_t mark) {
+        while (trail_.size() > mark) {
+            const Removal r = trail_.back();
+            trail_.pop_back();
+            const long before = deficit_of(u_.shifts[r.shift].required, dom_[r.shift]);
+            dom_[r.shift] |= r.bits;
+            future_deficit_ += deficit_of(u_.shifts[r.shift].required, dom_[r.shift]) - before;
+        }
+    }
+
+    bool same_profile(size_t a, size_t b) const {
+        const auto& wa = u_.workers[a];
+        const auto& wb = u_.workers[b];
+        if (wa.cap != wb.cap || wa.rest != wb.rest || wa.max_consecutive != wb.max_consecutive) return false;
+        for (const auto& sh : u_.shifts) {
+            if (((sh.eligible >> a) ^ (sh.eligible >> b)) & 1u) return false;
+            if (((sh.penalized >> a) ^ (sh.penalized >> b)) & 1u) return false;
+        }
+        return true;
+    }
+
+    // Two staff of one class who have worked the same minutes and days and can still take
+    // the same later shifts are interchangeable from shift i on
+    bool interchangeable(std::uint32_t i, size_t a, size_t b) const {
+        if (class_[a] != class_[b] || minutes_[a] != minutes_[b]) return false;
+        if (!std::equal(worked_.begin() + static_cast<std::ptrdiff_t>(a * day_words_),
+                        worked_.begin() + static_cast<std::ptrdiff_t>((a + 1) * day_words_),
+                        worked_.begin() + static_cast<std::ptrdiff_t>(b * day_words_))) return false;
+        for (size_t j = i + 1; j < dom_.size(); ++j) {
+            if (((dom_[j] >> a) ^ (dom_[j] >> b)) & 1u) return false;
+        }
+        return true;
+    }
+
+    bool worked(size_t w, std::int32_t d) const {
+        return (worked_[w * day_words_ + static_cast<size_t>(d >> 6)] >> (d & 63)) & 1u;
+    }
+
+    // The engine's rule (eligibility.hpp), on this unit's worked days
+    bool consecutive_ok(size_t w, std::int32_t day) const {
+        const std::int32_t limit = u_.workers[w].max_consecutive;
+        if (limit == INT32_MAX || day >= u_.days) return true;
+        return consecutive_run_ok([&](std::int32_t d) { return worked(w, d); }, day, u_.days, limit);
+    }
+
+    // Smallest spread any completion can reach if only `open` more slots may stay unfilled:
+    // the other remaining slots need at least that many minutes, which can only go to staff
+    // who can still take a shift, up to their caps, and are spread as evenly as possible.
+    // INT64_MAX if those staff cannot absorb them at all.
+    std::int64_t spread_bound(std::uint32_t i, int need, std::uint32_t from, std::uint32_t count, long open) const {
+        const long must = need + suffix_required_[i + 1] - open;
+        if (must <= 0) return spread_;
+        Minute shortest = suffix_min_duration_[i + 1];
+        if (need > 0) shortest = std::min(shortest, u_.shifts[i].duration());
+        const double load = static_cast<double>(must) * shortest;
+
+        std::uint64_t reach = 0;
+        const std::uint8_t* cand = &candidates_[i * ExactUnit::kMaxStaff];
+        for (std::uint32_t c = from; need > 0 && c < count; ++c) reach |= std::uint64_t{1} << cand[c];
+        for (size_t j = i + 1; j < dom_.size(); ++j) reach |= dom_[j];
+
+        // Water-fill with ceilings: every reachable total rises to a common level, capped
+        double fixed = 0, room = 0, low = INT32_MAX, high = 0;
+        for (size_t w = 0; w < minutes_.size(); ++w) {
+            const double m = minutes_[w];
+            if (!((reach >> w) & 1u)) {
+                fixed += m * m;
+                continue;
+            }
+            const double top = u_.workers[w].cap == INT32_MAX ? m + load : static_cast<double>(u_.workers[w].cap);
+            room += top - m;
+            low = std::min(low, m);
+            high = std::max(high, top);
+        }
+        if (room < load) return INT64_MAX;
+        auto filled = [&](double level, double& squares) {
+            double sum = 0;
+            squares = 0;
+            for (std::uint64_t bits = reach; bits; bits &= bits - 1) {
+                const auto w = static_cast<size_t>(lowest_staff(bits));
+                const double m = minutes_[w];
+                const double top = u_.workers[w].cap == INT32_MAX ? m + load : static_cast<double>(u_.workers[w].cap);
+                const double v = std::clamp(level, m, top);
+                sum += v - m;
+                squares += v * v;
+            }
+            return sum;
+        };
+        double squares = 0;
+        for (int step = 0; step < 50; ++step) {
+            const double mid = (low + high) / 2;
+            (filled(mid, squares) < load ? low : high) = mid;
+        }
+        filled(low, squares); // at most the true level: a lower bound
+        // Spreads are whole numbers: round up, less a margin for rounding in the fill
+        return std::max<std::int64_t>(spread_, static_cast<std::int64_t>(std::ceil((fixed + squares) * (1 - 1e-12) - 1e-6)));
+    }
+
+    // Slots the remaining hour caps cannot cover, in units of the longest remaining shift
+    long hours_deficit(std::uint32_t i, int need) const {
+        if (!all_capped_) return 0;
+        const std::int64_t demand = std::int64_t{need} * u_.shifts[i].duration() + suffix_demand_[i + 1];
+        const std::int64_t excess = demand - capacity_left_;
+        if (excess <= 0) return 0;
+        const std::int64_t longest = std::max(suffix_max_duration_[i], 1);
+        return static_cast<long>((excess + longest - 1) / longest);
+    }
+
+    // True if nothing below this node can beat the best schedule found so far
+    bool prune(std::uint32_t i, int need, std::uint32_t from, std::uint32_t count) const {
+        const long unreachable = std::max<long>(0, need - static_cast<long>(count - from));
+        const long short_bound = shortfall_ + std::max(unreachable + future_deficit_, hours_deficit(i, need));
+        if (short_bound != best_.shortfall) return short_bound > best_.shortfall;
+        ExactObjective bound;
+        bound.shortfall = short_bound;
+        bound.spread = u_.fairness ? spread_bound(i, need, from, count, best_.shortfall - shortfall_) : 0;
+        bound.preference_violations = u_.preferences ? preferences_ : 0;
+        return !(bound < best_);
+    }
+
+    bool out_of_budget() {
+        ++nodes_;
+        if (nodes_ >= limits_.nodes) stopped_ = true;
+        if ((nodes_ & 1023) == 0 && std::chrono::steady_clock::now() >= limits_.deadline) stopped_ = true;
+        return stopped_;
+    }
+
+    void shift(std::uint32_t i) {
+        if (stopped_) return;
+        if (i == u_.shifts.size()) {
+            const ExactObjective here{shortfall_, u_.fairness ? spread_ : 0, u_.preferences ? preferences_ : 0};
+            if (here < best_) {
+                best_ = here;
+                best_staffed_ = staffed_;
+            }
+            return;
+        }
+        const auto& sh = u_.shifts[i];
+        future_deficit_ -= deficit_of(sh.required, dom_[i]);
+
+        // Candidates in the engine's ranking: fewest minutes, no penalty, then index
+        std::uint8_t* cand = &candidates_[i * ExactUnit::kMaxStaff];
+        std::uint32_t count = 0;
+        for (std::uint64_t bits = dom_[i]; bits; bits &= bits - 1) {
+            const auto w = static_cast<std::uint8_t>(lowest_staff(bits));
+            if (consecutive_ok(w, sh.day)) cand[count++] = w;
+        }
+        std::sort(cand, cand + count, [&](std::uint8_t a, std::uint8_t b) {
+            if (u_.fairness && minutes_[a] != minutes_[b]) return minutes_[a] < minutes_[b];
+            const bool pa = u_.preferences && ((sh.penalized >> a) & 1u);
+            const bool pb = u_.preferences && ((sh.penalized >> b) & 1u);
+            if (pa != pb) return pb;
+            return a < b;
+        });
+
+        pick(i, 0, sh.required, count);
+        future_deficit_ += deficit_of(sh.required, dom_[i]);
+    }
+
+    // Staff shift i from candidates [from, count) with `need` slots still open: every subset
+    // in candidate order, the fuller ones first, then leave the remaining slots open. Taking
+    // a candidate after passing over one interchangeable with it only repeats a schedule
+    // already searched with the two swapped, so it is skipped.
+    void pick(std::uint32_t i, std::uint32_t from, int need, std::uint32_t count) {
+        if (out_of_budget()) return;
+        if (prune(i, need, from, count)) return;
+
+        const auto& sh = u_.shifts[i];
+        const std::uint8_t* cand = &candidates_[i * ExactUnit::kMaxStaff];
+        for (std::uint32_t c = from; need > 0 && c < count && !stopped_; ++c) {
+            const std::uint8_t w = cand[c];
+            bool repeat = false;
+            for (std::uint32_t p = from; p < c && !repeat; ++p) repeat = interchangeable(i, cand[p], w);
+            if (repeat) continue;
+            const std::uint64_t bit = std::uint64_t{1} << w;
+            const size_t mark = trail_.size();
+            const Minute before = minutes_[w];
+            const bool new_day = sh.day >= 0 && sh.day < u_.days && !worked(w, sh.day);
+
+            staffed_[i] |= bit;
+            minutes_[w] += sh.duration();
+            capacity_left_ -= sh.duration();
+            spread_ += std::int64_t{minutes_[w]} * minutes_[w] - std::int64_t{before} * before;
+            preferences_ += (sh.penalized >> w) & 1u;
+            if (new_day) worked_[w * day_words_ + static_cast<size_t>(sh.day >> 6)] |= std::uint64_t{1} << (sh.day & 63);
+
+            // Forward checking: later shifts too close to this one, or longer than the hours left
+            for (const auto& [j, mask] : conflicts_[i]) {
+                if (mask & bit) remove(j, bit);
+            }
+            const Minute left = u_.workers[w].cap == INT32_MAX ? INT32_MAX : u_.workers[w].cap - minutes_[w];
+            if (left < suffix_max_duration_[i + 1]) {
+                for (std::uint32_t j = i + 1; j < u_.shifts.size(); ++j) {
+                    if (u_.shifts[j].duration() > left) remove(j, bit);
+                }
+            }
+
+            pick(i, c + 1, need - 1, count);
+
+            backtrack(mark);
+            if (new_day) worked_[w * day_words_ + static_cast<size_t>(sh.day >> 6)] &= ~(std::uint64_t{1} << (sh.day & 63));
+            preferences_ -= (sh.penalized >> w) & 1u;
+            spread_ -= std::int64_t{minutes_[w]} * minutes_[w] - std::int64_t{before} * before;
+            minutes_[w] = before;
+            capacity_left_ += sh.duration();
+            staffed_[i] &= ~bit;
+        }
+        if (stopped_) return;
+
+        shortfall_ += std::max(need, 0);
+        shift(i + 1);
+        shortfall_ -= std::max(need, 0);
+    }
+
+    const ExactUnit& u_;
+    const ExactLimits& limits_;
+
+    std::vector<std::vector<Removal>> conflicts_; // per shift: later shift and the staff it excludes
+    std::vector<long> suffix_required_;
+    std::vector<Minute> suffix_min_duration_;     // over shifts with a requirement
+    std::vector<Minute> suffix_max_duration_;
+    std::vector<std::int64_t> suffix_demand_;     // required minutes
+    bool all_capped_ = false;                     // every worker has an hour cap
+    size_t day_words_ = 0;
+
+    // Search state
+    std::vector<std::uint64_t> dom_;        // staff who can still take each shift
+    std::vector<std::uint64_t> staffed_;    // staff taken per shift so far
+    std::vector<std::uint64_t> worked_;     // worker-major day bitsets
+    std::vector<Minute> minutes_;
+    std::vector<std::uint8_t> candidates_;  // per shift, kMaxStaff entries
+    std::vector<std::uint8_t> class_;       // lowest worker with the same profile
+    std::vector<Removal> trail_;
+    long shortfall_ = 0;
+    long future_deficit_ = 0;               // sum of deficits of the shifts after the current one
+    std::int64_t spread_ = 0;
+    std::int64_t capacity_left_ = 0;        // sum of hour caps minus assigned minutes
+    long preferences_ = 0;
+
+    ExactObjective best_;
+    std::vector<std::uint64_t> best_staffed_;
+    std::uint64_t nodes_ = 0;
+    bool stopped_ = false;
+};
+
+} // namespace
+
+ExactObjective evaluate_exact(const ExactUnit& unit, const std::vector<std::uint64_t>& staffed) {
+    ExactObjective obj;
+    std::vector<std::int64_t> minutes(unit.workers.size(), 0);
+    for (size_t i = 0; i < unit.shifts.size(); ++i) {
+        const auto& sh = unit.shifts[i];
+        obj.shortfall += std::max<long>(0, sh.required - count_staff(staffed[i]));
+        for (std::uint64_t bits = staffed[i]; bits; bits &= bits - 1) {
+            const int w = lowest_staff(bits);
+            minutes[static_cast<size_t>(w)] += sh.duration();
+            obj.preference_violations += (sh.penalized >> w) & 1u;
+        }
+    }
+    if (unit.fairness) {
+        for (std::int64_t m : minutes) obj.spread += m * m;
+    }
+    if (!unit.preferences) obj.preference_violations = 0;
+    return obj;
+}
+
+ExactSolution solve_exact(const ExactUnit& unit, const std::vector<std::uint64_t>& incumbent,
+                          const ExactLimits& limits) {
+    ExactSolution out;
+    Search search(unit, limits);
+    search.run(incumbent, out);
+    return out;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+// Exact search for one small unit (a role's staff and shifts): depth-first branch and bound
+// over the shifts in start order, with each shift's eligible staff as a 64-bit mask. Taking a
+// worker forward-checks the later shifts (rest and hours remove the worker from their masks),
+// so a shift's mask is always a superset of who can still take it and slots no mask can
+// cover give the coverage bound. The schedule passed in is the first incumbent: the result
+// is either strictly better or that schedule unchanged.
+
+// Lexicographic objective (lower is better): coverage, then fairness, then preferences
+struct ExactObjective {
+    long shortfall = 0;              // required slots left unfilled
+    std::int64_t spread = 0;         // sum over staff of assigned minutes squared
+    long preference_violations = 0;  // assignments that break a staff preference
+
+    bool operator<(const ExactObjective& o) const {
+        if (shortfall != o.shortfall) return shortfall < o.shortfall;
+        if (spread != o.spread) return spread < o.spread;
+        return preference_violations < o.preference_violations;
+    }
+};
+
+struct ExactUnit {
+    static constexpr size_t kMaxStaff = 64; // one bit per worker
+
+    struct Shift {
+        std::int32_t start = 0;       // minutes; shifts are listed in start order
+        std::int32_t end = 0;
+        std::int32_t day = 0;         // day index for the consecutive-days limit
+        std::int32_t required = 0;
+        std::uint64_t eligible = 0;   // staff allowed by availability, skills and an hour cap >= the shift
+        std::uint64_t penalized = 0;  // staff for whom the shift breaks a preference
+        std::int32_t duration() const { return end - start; }
+    };
+    struct Worker {
+        std::int32_t cap = INT32_MAX;             // minutes over the horizon
+        std::int32_t rest = INT32_MIN;            // minutes between shifts (INT32_MIN: may even overlap)
+        std::int32_t max_consecutive = INT32_MAX; // worked days in a row
+    };
+
+    std::vector<Shift> shifts;
+    std::vector<Worker> workers; // at most kMaxStaff
+    std::int32_t days = 0;       // day indices run 0 .. days - 1
+    bool fairness = true;        // count ExactObjective::spread
+    bool preferences = true;     // count ExactObjective::preference_violations
+};
+
+struct ExactLimits {
+    std::uint64_t nodes = 1'000'000;
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+};
+
+struct ExactSolution {
+    std::vector<std::uint64_t> staffed; // staff mask per shift
+    ExactObjective objective;
+    ExactObjective incumbent;           // of the schedule passed in
+    std::uint64_t nodes = 0;
+    bool optimal = false;               // the search finished: nothing better exists
+    bool improved = false;              // objective < incumbent
+};
+
+// Objective of a schedule given as one staff mask per shift
+ExactObjective evaluate_exact(const ExactUnit& unit, const std::vector<std::uint64_t>& staffed);
+
+// Best schedule for the unit within the limits, starting from a feasible `incumbent`
+ExactSolution solve_exact(const ExactUnit& unit, const std::vector<std::uint64_t>& incumbent,
+                          const ExactLimits& limits = ExactLimits{});
@@ -1,27 +1,68 @@
 
 #include "input_parser.hpp"
-#include "../extern/json.hpp" // Using json header from nlohmann/json
+#include "json_view.hpp" // nlohmann/json stays behind this interface
 #include "model.hpp"
-#include <iostream>
-
-using nlohmann::json;
+#include <stdexcept>
 
 // Helper to set from json
-static std::unordered_set<std::string> to_set(const json& arr) {
+static std::unordered_set<std::string> to_set(const JsonView& arr) {
     std::unordered_set<std::string> s;
     if (!arr.is_array()) return s;
-    for (auto& v : arr) s.insert(v.get<std::string>());
+    for (auto v : arr) s.insert(v.get_string());
     return s;
 }
 
+// One staff member (limits not given fall back to the rules' defaults)
+static Staff parse_staff(const JsonView& s, const Rules& rules) {
+    Staff stf;
+    stf.id = s.at("id").get_string();
+    stf.name = s.value("name", stf.id);
+    stf.role = s.value("role", "");
+    if (s.contains("skills")) {
+        for (auto sk : s["skills"]) {
+            stf.skills.insert(sk.get_string());
+        }
+    }
+
+    stf.max_weekly_hours = s.value("max_weekly_hours", rules.max_hours_per_week_default);
+    stf.max_consecutive_days = s.value("max_consecutive_days", rules.max_consecutive_days_default);
+    stf.min_rest = s.value("min_rest", rules.min_rest_hours_default);
+
+    if (s.contains("preferences")) {
+        JsonView p = s["preferences"];
+        stf.prefs.avoid_nights = p.value("avoid_nights", false);
+        if (p.contains("preferred_unit")) {
+            for (auto u : p["preferred_unit"]) {
+                stf.prefs.preferred_unit.insert(u.get_string());
+            }
+        }
+    }
+
+    if (s.contains("availability")) {
+        for (auto a : s["availability"]) {
+            Availability av;
+            DateStamp ds;
+            if (!parse_date(a.at("date").get_string(), ds)) {
+                throw std::runtime_error("Bad availability date.");
+            }
+            av.date = ds;
+            av.can_work = a.value("can_work", true);
+            stf.availability.push_back(av);
+        }
+    }
+
+    return stf;
+}
+
 InputModel parse_input_json(const std::string& text, const Filters& opt) {
-    json j = json::parse(text);
+    JsonDocument doc(text);
+    JsonView j = doc.root();
 
     InputModel i_model;
 
     // Rules
     if (j.contains("rules")) {
-        auto r = j["rules"];
+        JsonView r = j["rules"];
         i_model.rules.max_hours_per_week_default = r.value("max_hours_per_week_default", 40);
         i_model.rules.max_consecutive_days_default = r.value("max_consecutive_days_default", 5);
         i_model.rules.min_rest_hours_default = r.value("min_rest_hours_default", 12);
@@ -31,75 +72,75 @@ InputModel parse_input_json(const std::string& text, const Filters& opt) {
         if (r.contains("soft_constraints")) {
             i_model.rules.soft_constraints = to_set(r["soft_constraints"]);
         }
+        if (r.contains("objective_weights")) {
+            JsonView w = r["objective_weights"];
+            ObjectiveWeights& ow = i_model.rules.objective;
+            ow.shortfall = w.value("shortfall", ow.shortfall);
+            ow.hours_variance = w.value("hours_variance", ow.hours_variance);
+            ow.preference = w.value("preference", ow.preference);
+            ow.night_variance = w.value("night_variance", ow.night_variance);
+        }
     }
     // Staff
-    for (auto& s : j.at("staff")) {
-        Staff stf;
-        stf.id = s.at("id").get<std::string>();
-        stf.name = s.value("name", stf.id);
-        stf.role = s.value("role", "");
-        if (s.contains("skills")) {
-            for (auto& sk : s["skills"]) {
-                stf.skills.insert(sk.get<std::string>());
-            }
+    i_model.staff.reserve(j.at("staff").size());
+    for (auto s : j.at("staff")) {
+        i_model.staff.push_back(parse_staff(s, i_model.rules));
+    }
+
+    // Shifts (once, not per staff member)
+    i_model.shifts.reserve(j.at("shifts").size());
+    for (auto sh : j.at("shifts")) {
+        Shifts shf;
+        shf.id   = sh.at("id").get_string();
+        shf.name = sh.value("name", "");
+        if (!opt.only_shown.empty() && shf.name != opt.only_shown) {
+            continue; // Applying filter
         }
 
-        stf.max_weekly_hours = s.value("max_weekly_hours", i_model.rules.max_hours_per_week_default);
-        stf.max_consecutive_days = s.value("max_consecutive_days", i_model.rules.max_consecutive_days_default);
-        stf.min_rest = s.value("min_rest", i_model.rules.min_rest_hours_default);
-
-        if (s.contains("preferences")) {
-            auto p = s["preferences"];
-            stf.prefs.avoid_nights = p.value("avoid_nights", false);
-            if (p.contains("preferred_unit")) {
-                for (auto& u : p["preferred_unit"]) {
-                    stf.prefs.preferred_unit.insert(u.get<std::string>());
-                }
-            }
+        {
+            DateTimeStamp dt{};
+            if (!parse_datetime(sh.at("start").get_string(), dt)) throw std::runtime_error("Bad shift start");
+            shf.start = to_time_point(dt);
+        }
+        {
+            DateTimeStamp dt{};
+            if (!parse_datetime(sh.at("end").get_string(), dt)) throw std::runtime_error("Bad shift end");
+            shf.end = to_time_point(dt);
         }
 
-        if (s.contains("availability")) {
-            for (auto& a : s["availability"]) {
-                Availability av;
-                DateStamp ds;
-                if (!parse_date(a.at("date").get<std::string>(), ds)) {
-                    throw std::runtime_error("Bad availability date.");
-                }
-                av.date = ds;
-                av.can_work = a.value("can_work", true);
-                stf.availability.push_back(av);
+        shf.req_role  = sh.value("req_role", "");
+        if (sh.contains("required_skills")) {
+            for (auto sk : sh["required_skills"]) {
+                shf.req_skills.push_back(sk.get_string());
             }
         }
+        shf.required_count = sh.value("required_count", 1);
+        i_model.shifts.push_back(std::move(shf));
+    }
 
-        i_model.staff.push_back(std::move(stf));
+    index_shifts(i_model);
 
-        // Shifts
-        for (auto& sh : j.at("shifts")) {
-            Shifts shf;
-            shf.id   = sh.at("id").get<std::string>();
-            shf.name = sh.value("name", "");
-            if (!opt.only_shown.empty() && shf.name != opt.only_shown) {
-                continue; // Applying filter
-            }
+    return i_model;
 
-            {
-                DateTimeStamp dt{};
-                if (!parse_datetime(sh.at("start").get<std::string>(), dt)) throw std::runtime_error("Bad shift start");
-                shf.start = to_time_point(dt);
-            }
-            {
-                DateTimeStamp dt{};
-                if (!parse_datetime(sh.at("end").get<std::string>(), dt)) throw std::runtime_error("Bad shift end");
-                shf.end = to_time_point(dt);
-            }
+}
 
-            shf.req_role  = sh.value("req_role", "");
-            shf.required_count = sh.value("required_count", 1);
-            i_model.shifts.push_back(std::move(shf)); 
+std::vector<ScenarioOverlay> parse_scenarios_json(const std::string& text, const Rules& rules) {
+    JsonDocument doc(text);
+    JsonView j = doc.root();
+
+    std::vector<ScenarioOverlay> out;
+    out.reserve(j.at("scenarios").size());
+    for (auto sc : j.at("scenarios")) {
+        ScenarioOverlay ov;
+        ov.name = sc.at("name").get_string();
+        if (sc.contains("fairness")) ov.fairness_on = sc["fairness"].get_bool();
+        if (sc.contains("preferences")) ov.respect_preferences = sc["preferences"].get_bool();
+        if (sc.contains("max_weekly_hours")) ov.max_weekly_hours = static_cast<short>(sc["max_weekly_hours"].get_int());
+        if (sc.contains("add_staff")) {
+            for (auto s : sc["add_staff"]) ov.extra_staff.push_back(parse_staff(s, rules));
         }
-
+        if (sc.contains("close_units")) ov.closed_units = to_set(sc["close_units"]);
+        out.push_back(std::move(ov));
     }
-
-    return i_model;
-
+    return out;
 }
@@ -1,6 +1,8 @@
 #pragma once
 #include <string>
+#include <vector>
 #include "model.hpp"
+#include "scenario.hpp"
 
 struct Filters // Optional to add filter, selected is only_shown and none is all
 {
@@ -8,4 +10,9 @@ struct Filters // Optional to add filter, selected is only_shown and none is all
 };
 
 // Need to make Model.
-InputModel parse_input_json(const std::string& json_text, const Filters& opt = Filters{});
\ No newline at end of file
+InputModel parse_input_json(const std::string& json_text, const Filters& opt = Filters{});
+
+// What-if overlays: {"scenarios": [{"name": ..., "fairness": bool, "preferences": bool,
+// "max_weekly_hours": int, "add_staff": [staff...], "close_units": [unit...]}, ...]}.
+// Added staff use the same format (and rule defaults) as the input file.
+std::vector<ScenarioOverlay> parse_scenarios_json(const std::string& json_text, const Rules& rules);
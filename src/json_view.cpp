@@ -0,0 +1,56 @@
+#include "json_view.hpp"
+#include "../extern/json.hpp" // Using json header from nlohmann/json (only included here)
+#include <stdexcept>
+
+using nlohmann::json;
+
+// Helpers
+
+static const json& node(const void* p) {
+    static const json null_json;
+    return p ? *static_cast<const json*>(p) : null_json;
+}
+
+// Document
+
+struct JsonDocument::Impl {
+    json root;
+};
+
+JsonDocument::JsonDocument(const std::string& text) : impl_(new Impl{json::parse(text)}) {}
+JsonDocument::~JsonDocument() = default;
+JsonDocument::JsonDocument(JsonDocument&&) noexcept = default;
+JsonDocument& JsonDocument::operator=(JsonDocument&&) noexcept = default;
+
+JsonView JsonDocument::root() const { return JsonView(&impl_->root); }
+
+// View
+
+bool JsonView::is_null() const { return node(node_).is_null(); }
+bool JsonView::is_array() const { return node(node_).is_array(); }
+bool JsonView::is_object() const { return node(node_).is_object(); }
+
+bool JsonView::contains(const char* key) const { return node(node_).contains(key); }
+
+JsonView JsonView::at(const char* key) const { return JsonView(&node(node_).at(key)); }
+
+JsonView JsonView::operator[](const char* key) const {
+    const json& j = node(node_);
+    if (!j.is_object()) return JsonView();
+    auto it = j.find(key);
+    return it == j.end() ? JsonView() : JsonView(&*it);
+}
+
+int JsonView::value(const char* key, int def) const { return node(node_).value(key, def); }
+bool JsonView::value(const char* key, bool def) const { return node(node_).value(key, def); }
+double JsonView::value(const char* key, double def) const { return node(node_).value(key, def); }
+std::string JsonView::value(const char* key, const char* def) const { return node(node_).value(key, std::string(def)); }
+std::string JsonView::value(const char* key, const std::string& def) const { return node(node_).value(key, def); }
+
+std::size_t JsonView::size() const { return node(node_).size(); }
+JsonView JsonView::operator[](std::size_t i) const { return JsonView(&node(node_).at(i)); }
+
+std::string JsonView::get_string() const { return node(node_).get<std::string>(); }
+int JsonView::get_int() const { return node(node_).get<int>(); }
+bool JsonView::get_bool() const { return node(node_).get<bool>(); }
+double JsonView::get_double() const { return node(node_).get<double>(); }
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+
+// Light read-only access to a parsed JSON document.
+// nlohmann/json is only included by json_view.cpp, so parser front-ends built on
+// this header don't pay for the 25k-line header and its template instantiations.
+// Errors (bad syntax, missing keys, wrong types) throw std::exception subclasses.
+
+class JsonView {
+public:
+    JsonView() = default;
+
+    bool is_null() const;
+    bool is_array() const;
+    bool is_object() const;
+
+    // Objects
+    bool contains(const char* key) const;
+    JsonView at(const char* key) const;         // throws if missing
+    JsonView operator[](const char* key) const; // null view if missing
+
+    // Typed member lookup with default (throws if present with the wrong type)
+    int value(const char* key, int def) const;
+    bool value(const char* key, bool def) const;
+    double value(const char* key, double def) const;
+    std::string value(const char* key, const char* def) const;
+    std::string value(const char* key, const std::string& def) const;
+
+    // Arrays
+    std::size_t size() const;
+    JsonView operator[](std::size_t i) const;
+
+    // Scalars (throw on type mismatch)
+    std::string get_string() const;
+    int get_int() const;
+    bool get_bool() const;
+    double get_double() const;
+
+    // Range-for over array elements
+    class Iterator {
+    public:
+        Iterator(const JsonView* arr, std::size_t i) : arr_(arr), i_(i) {}
+        JsonView operator*() const { return (*arr_)[i_]; }
+        Iterator& operator++() { ++i_; return *this; }
+        bool operator!=(const Iterator& o) const { return i_ != o.i_; }
+    private:
+        const JsonView* arr_;
+        std::size_t i_;
+    };
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, is_array() ? size() : 0); }
+
+private:
+    friend class JsonDocument;
+    explicit JsonView(const void* node) : node_(node) {}
+    const void* node_ = nullptr; // const nlohmann::json*, null for missing members
+};
+
+// Owns a parsed document; views stay valid while it lives
+class JsonDocument {
+public:
+    explicit JsonDocument(const std::string& text);
+    ~JsonDocument();
+    JsonDocument(JsonDocument&&) noexcept;
+    JsonDocument& operator=(JsonDocument&&) noexcept;
+
+    JsonView root() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
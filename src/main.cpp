@@ -1,70 +1,71 @@
 #include "model.hpp"
 #include "input_parser.hpp"
 #include "engine.hpp"
+#include "profiler.hpp"
+#include "csv_writer.hpp"
+#include "simulation.hpp"
+#include "portfolio.hpp"
+#include "presolve.hpp"
+#include "score.hpp"
+#include "validate.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <fstream>
 #include <sstream>
+#include <iomanip>
 #include <iostream>
-#include <vector>
+#include <iterator>
+#include <memory>
 #include <string>
-#include <unordered_map>
-#include <algorithm>
+#include <optional>
 
 // Helper Functions
 
 // Usage to help run program
 static void print_usage() {
     std::cout << "Usage:\n"
-              << "  scheduler <input.json> [--unit UNIT_NAME] [--csv OUTPUT.csv]\n"
+              << "  scheduler <input.json> [--unit UNIT_NAME] [--csv OUTPUT.csv] [--diagnostics] [--stats] [--order start|scarcity] [--exact [--exact-ms MS]] [--anneal MS [--seed S]]\n"
+              << "  scheduler <input.json> --scenarios SCENARIOS.json [--threads N] [--unit UNIT_NAME] [--csv OUTPUT.csv] [--order start|scarcity] [--exact [--exact-ms MS]] [--anneal MS [--seed S]]\n"
+              << "  scheduler <input.json> --presolve [--unit UNIT_NAME] [--csv OUTPUT.csv]\n"
+              << "  scheduler <input.json> --portfolio PASSES [--seed S] [--threads N] [other flags]\n"
+              << "  scheduler <input.json> --simulate SAMPLES [--callout-rate P] [--seed S] [--threads N] [other flags]\n"
+              << "  scheduler --validate <input.json> <schedule.csv> [--threads N]\n"
               << "\nIf --csv is not provided, the program automatically creates:\n"
               << "  schedule.csv\n"
               << "or, if --unit is given:\n"
-              << "  schedule_<unit>.csv\n\n";
-}
-
-// Format time into string for CSV
-static std::string format_time(const SysTime& t) {
-    std::time_t tt = Clock::to_time_t(t);
-    std::tm* tm = std::localtime(&tt);
-    char buf[32];
-    if (std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M", tm)) {
-        return std::string(buf);
-    }
-    return "";
+              << "  schedule_<unit>.csv\n"
+              << "\n--diagnostics also writes <base>_diagnostics.csv with per-shift rejection counts.\n"
+              << "--stats also writes <base>_stats.json with phase timings and counters.\n"
+              << "--scenarios runs the base model plus every what-if scenario in parallel and writes\n"
+              << "  <base>_scenarios.csv with coverage and fairness per scenario (no schedule CSVs);\n"
+              << "  --order, --exact and --anneal apply to every scenario.\n"
+              << "--presolve only checks the input: it reports the shortfall no schedule can avoid (per role\n"
+              << "  and per overlapping time slice) and writes <base>_presolve.csv, without scheduling.\n"
+              << "--order scarcity staffs the shifts with the fewest eligible staff per slot first\n"
+              << "  (default: start, in start time order).\n"
+              << "--exact re-solves every role with at most 40 staff and 200 shifts by branch and bound,\n"
+              << "  keeping a result only if it beats the greedy one (coverage, then fairness, then\n"
+              << "  preferences); the search stops after MS milliseconds in total (default 500).\n"
+              << "--anneal improves the schedule by simulated annealing for MS milliseconds, keeping it\n"
+              << "  only if its score (shortfall, hours variance, preferences) went down.\n"
+              << "--portfolio runs PASSES greedy passes (the first one plain, the rest with seeded random\n"
+              << "  tie-breaking) in parallel and keeps the best by shortfall, hours variance and preferences.\n"
+              << "--simulate replays random staff call-outs (default rate 0.05 per staff-day) against the\n"
+              << "  schedule, repairs each sample greedily and writes <base>_simulation.csv.\n"
+              << "--validate checks a schedule CSV (e.g. edited by hand) against the input's hard constraints,\n"
+              << "  writes <schedule>_violations.csv and exits with 10 if anything is violated.\n\n";
 }
 
-// Join staff 
-static std::string join_staff_ids(const std::vector<std::string>& ids) {
-    std::string out;
-    for (size_t i = 0; i < ids.size(); ++i) {
-        out += ids[i];
-        if (i + 1 < ids.size()) out += ";";
-    }
-    return out;
-}
-
-// Compute total staff hours
-static std::unordered_map<std::string, Hours> compute_staff_hours(const InputModel& model, const ScheduleResult& result) {
-    std::unordered_map<std::string, Hours> totals;
-
-    // Map shift_id -> Shifts*
-    std::unordered_map<std::string, const Shifts*> shift_by_id;
-    for (const auto& sh : model.shifts) {
-        shift_by_id[sh.id] = &sh;
-    }
-
-    // Sum the hours
-    for (const auto& asg : result.assignments) {
-        auto iter = shift_by_id.find(asg.shift_id);
-        if (iter == shift_by_id.end()) continue;
-        const Shifts* sh = iter->second;
-        Hours dur = sh->duration();
-        for (const auto& sid : asg.staff_ids) {
-            totals[sid] += dur;
-        }
-    }
-
-    return totals;
+// Read a whole file (false if it can't be opened)
+static bool read_text_file(const std::string& path, std::string& out) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    out = buffer.str();
+    return true;
 }
 
 // Rename flag
@@ -75,105 +76,89 @@ static std::string base_name_from_csv(const std::string& csv_path) {
     return csv_path.substr(0, pos);
 }
 
-// Schedule CSV Writer
-static bool write_schedule_csv(const InputModel& model, const ScheduleResult& result, const std::string& csv_path) {
-    // Output file verification
-    std::ofstream out(csv_path);
-    if (!out) {
-        std::cerr << "Error: Cannot open CSV file for writing: " << csv_path << "\n";
-        return false;
+// Schedule audit: --validate <input.json> <schedule.csv> [--threads N]
+static int run_validate(int argc, char** argv) {
+    if (argc < 4) {
+        print_usage();
+        return 1;
     }
-
-    // Map shift_id -> assignment pointer
-    std::unordered_map<std::string, const Assignment*> asg_by_shift;
-    for (const auto& a : result.assignments) {
-        asg_by_shift[a.shift_id] = &a;
+    const std::string input_path = argv[2];
+    const std::string schedule_path = argv[3];
+    unsigned threads = 0;
+    for (int i = 4; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            char* end = nullptr;
+            threads = static_cast<unsigned>(std::strtoul(argv[++i], &end, 10));
+            if (*end != '\0') {
+                std::cerr << "Invalid thread count: " << argv[i] << "\n";
+                return 1;
+            }
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << "\n";
+            print_usage();
+            return 1;
+        }
     }
 
-    // Build a list of shift indices and sort by start time
-    std::vector<const Shifts*> ordered_shifts;
-    ordered_shifts.reserve(model.shifts.size());
-    for (const auto& sh : model.shifts) ordered_shifts.push_back(&sh);
-    std::sort(ordered_shifts.begin(), ordered_shifts.end(),
-              [](const Shifts* a, const Shifts* b) { return a->start < b->start; });
-
-    // CSV Headers
-    out << "shift_id,unit,start,end,required_role,required_count,"
-           "assigned_count,assigned_staff_ids,coverage_ok,missing_count\n";
-
-    // Extract data from assignments
-    for (const auto* sh : ordered_shifts) {
-        const Assignment* asg = nullptr;
-        auto it = asg_by_shift.find(sh->id);
-        if (it != asg_by_shift.end()) asg = it->second;
-
-        int assigned_count = asg ? static_cast<int>(asg->staff_ids.size()) : 0;
-        int required = sh->required_count;
-        bool coverage_ok = (assigned_count >= required);
-        int missing = (required > assigned_count) ? (required - assigned_count) : 0;
-
-        std::string staff_joined = asg ? join_staff_ids(asg->staff_ids) : "";
-
-        // Format output to cells
-        out << sh->id << ","
-            << sh->name << ","
-            << format_time(sh->start) << ","
-            << format_time(sh->end) << ","
-            << sh->req_role << ","
-            << required << ","
-            << assigned_count << ","
-            << staff_joined << ","
-            << (coverage_ok ? "Yes" : "No") << ","
-            << missing << "\n";
+    std::string json_text;
+    if (!read_text_file(input_path, json_text)) {
+        std::cerr << "Error: Cannot open input file: " << input_path << "\n";
+        return 2;
     }
-
-    return true;
-}
-
-// Staff summary CSV (hours per staff) writer
-static bool write_staff_summary_csv(const InputModel& model, const std::unordered_map<std::string, Hours>& totals, const std::string& csv_path) {
-    std::ofstream out(csv_path);
-    if (!out) {
-        std::cerr << "Error: Cannot open CSV file for writing: " << csv_path << "\n";
-        return false;
+    InputModel model;
+    try {
+        model = parse_input_json(json_text);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: Failed to parse JSON: " << e.what() << "\n";
+        return 3;
     }
-
-    // Headers
-    out << "staff_id,name,role,total_hours\n";
-
-    // Loop through staff to get data
-    for (const auto& s : model.staff) {
-        auto it = totals.find(s.id);
-        Hours h = Hours{0};
-        if (it != totals.end()) h = it->second;
-        auto h_int = std::chrono::duration_cast<Hours>(h).count();
-
-        // Format data
-        out << s.id << ","
-            << s.name << ","
-            << s.role << ","
-            << h_int << "\n";
+    std::ifstream csv(schedule_path);
+    if (!csv) {
+        std::cerr << "Error: Cannot open schedule file: " << schedule_path << "\n";
+        return 2;
     }
 
-    return true;
-}
-
-// Warnings CSV writer
-static bool write_warnings_csv(const ScheduleResult& result, const std::string& csv_path)
-{
-    std::ofstream out(csv_path);
-    if (!out) {
-        std::cerr << "Error: Cannot open CSV file for writing: " << csv_path << "\n";
-        return false;
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<Violation> problems;
+    ScheduleResult schedule;
+    try {
+        schedule = read_schedule_csv(model, csv, problems);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: Failed to read schedule " << schedule_path << ": " << e.what() << "\n";
+        return 3;
     }
-
-    // Adds warnings to CSV
-    out << "index,warning\n";
-    for (size_t i = 0; i < result.warnings.size(); ++i) {
-        out << i << "," << result.warnings[i] << "\n";
+    ValidationReport report = validate_schedule(model, schedule, threads);
+    auto t1 = std::chrono::steady_clock::now();
+    problems.insert(problems.end(), std::make_move_iterator(report.violations.begin()),
+                    std::make_move_iterator(report.violations.end()));
+    const ScheduleScore score = score_schedule(model, schedule);
+
+    std::cout << "=== Hospital Scheduler: validate ===\n"
+              << "Input: " << input_path << "\n"
+              << "Schedule: " << schedule_path << "\n"
+              << "Checked " << report.assignments << " assignments of " << report.staff_checked << " staff in "
+              << std::fixed << std::setprecision(1) << std::chrono::duration<double, std::milli>(t1 - t0).count()
+              << " ms\n" << std::defaultfloat
+              << "Coverage: " << score.filled_slots << " of " << score.required_slots << " required slots ("
+              << score.short_shifts << " shifts short)\n"
+              << "--------------------------\n";
+    const size_t shown = std::min<size_t>(problems.size(), 20); // the CSV has all of them
+    for (size_t i = 0; i < shown; ++i) {
+        const Violation& v = problems[i];
+        std::cout << violation_name(v.kind) << ": " << (v.staff_id.empty() ? "" : v.staff_id + " on ")
+                  << v.shift_id << ": " << v.detail << "\n";
     }
+    if (shown < problems.size()) std::cout << "... " << problems.size() - shown << " more\n";
+    std::cout << problems.size() << (problems.size() == 1 ? " violation\n" : " violations\n");
 
-    return true;
+    const std::string violations_csv = base_name_from_csv(schedule_path) + "_violations.csv";
+    if (!write_violations_csv(problems, violations_csv)) {
+        std::cerr << "Failed to write violations CSV.\n";
+        return 4;
+    }
+    std::cout << "Violations CSV written to: " << violations_csv << "\n";
+    return problems.empty() ? 0 : 10;
 }
 
 // Main function
@@ -183,10 +168,23 @@ int main(int argc, char** argv) {
         print_usage();
         return 1;
     }
+    if (std::string(argv[1]) == "--validate") return run_validate(argc, argv);
 
     std::string input_path = argv[1];
     std::string unit_filter;
     std::string csv_output_path;  // optional: rename file
+    bool diagnostics = false;     // optional: rejection report
+    bool stats = false;           // optional: phase timings
+    std::string scenarios_path;   // optional: what-if batch mode
+    unsigned threads = 0;         // scenario/simulation threads (0 = one per core)
+    ShiftOrder shift_order = ShiftOrder::Start;
+    bool presolve_only = false;   // optional: lower bounds, no schedule
+    ExactOptions exact;           // optional: branch and bound for small roles
+    std::uint32_t anneal_ms = 0;  // optional: simulated annealing budget
+    unsigned portfolio = 0;       // optional: multi-start passes (0 = single pass)
+    std::uint64_t seed = 1;       // portfolio, simulation and anneal seed
+    SimulationOptions sim;        // optional: call-out simulation
+    sim.samples = 0;
 
     // Parse flags
     for (int i = 2; i < argc; ++i) {
@@ -199,6 +197,97 @@ int main(int argc, char** argv) {
         else if (arg == "--csv" && i + 1 < argc) {
             csv_output_path = argv[++i];
         }
+        // Diagnostics flag
+        else if (arg == "--diagnostics") {
+            diagnostics = true;
+        }
+        // Stats flag
+        else if (arg == "--stats") {
+            stats = true;
+        }
+        // What-if scenarios
+        else if (arg == "--scenarios" && i + 1 < argc) {
+            scenarios_path = argv[++i];
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            char* end = nullptr;
+            threads = static_cast<unsigned>(std::strtoul(argv[++i], &end, 10));
+            if (*end != '\0') {
+                std::cerr << "Invalid thread count: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        // Pre-solve check
+        else if (arg == "--presolve") {
+            presolve_only = true;
+        }
+        // Staffing order
+        else if (arg == "--order" && i + 1 < argc) {
+            std::string order = argv[++i];
+            if (order == "start") {
+                shift_order = ShiftOrder::Start;
+            } else if (order == "scarcity") {
+                shift_order = ShiftOrder::Scarcity;
+            } else {
+                std::cerr << "Unknown order: " << order << " (expected start or scarcity)\n";
+                return 1;
+            }
+        }
+        // Exact search for small roles
+        else if (arg == "--exact") {
+            exact.enabled = true;
+        }
+        else if (arg == "--exact-ms" && i + 1 < argc) {
+            char* end = nullptr;
+            exact.time_limit_ms = static_cast<std::uint32_t>(std::strtoul(argv[++i], &end, 10));
+            if (*end != '\0') {
+                std::cerr << "Invalid time limit: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        // Simulated annealing
+        else if (arg == "--anneal" && i + 1 < argc) {
+            char* end = nullptr;
+            anneal_ms = static_cast<std::uint32_t>(std::strtoul(argv[++i], &end, 10));
+            if (*end != '\0' || anneal_ms == 0) {
+                std::cerr << "Invalid time budget: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        // Multi-start portfolio
+        else if (arg == "--portfolio" && i + 1 < argc) {
+            char* end = nullptr;
+            portfolio = static_cast<unsigned>(std::strtoul(argv[++i], &end, 10));
+            if (*end != '\0' || portfolio == 0) {
+                std::cerr << "Invalid pass count: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        // Call-out simulation
+        else if (arg == "--simulate" && i + 1 < argc) {
+            char* end = nullptr;
+            sim.samples = static_cast<unsigned>(std::strtoul(argv[++i], &end, 10));
+            if (*end != '\0' || sim.samples == 0) {
+                std::cerr << "Invalid sample count: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--callout-rate" && i + 1 < argc) {
+            char* end = nullptr;
+            sim.callout_rate = std::strtod(argv[++i], &end);
+            if (*end != '\0' || !(sim.callout_rate >= 0.0 && sim.callout_rate <= 1.0)) {
+                std::cerr << "Invalid call-out rate (expected 0..1): " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--seed" && i + 1 < argc) {
+            char* end = nullptr;
+            seed = std::strtoull(argv[++i], &end, 10);
+            if (*end != '\0') {
+                std::cerr << "Invalid seed: " << argv[i] << "\n";
+                return 1;
+            }
+        }
         else {
             std::cerr << "Unknown or incomplete option: " << arg << "\n";
             print_usage();
@@ -206,16 +295,41 @@ int main(int argc, char** argv) {
         }
     }
 
-    // Open JSON file
-    std::ifstream in(input_path);
-    if (!in) {
-        std::cerr << "Error: Cannot open input file: " << input_path << "\n";
-        return 2;
+    // Modes that don't combine: the pre-solve check builds no schedule, and scenarios only
+    // write the comparison table
+    const char* conflict = nullptr;
+    if (presolve_only) {
+        if (!scenarios_path.empty()) conflict = "--scenarios";
+        else if (portfolio > 0) conflict = "--portfolio";
+        else if (sim.samples > 0) conflict = "--simulate";
+        else if (exact.enabled) conflict = "--exact";
+        else if (anneal_ms > 0) conflict = "--anneal";
+        else if (diagnostics) conflict = "--diagnostics";
+        else if (stats) conflict = "--stats";
+    } else if (!scenarios_path.empty()) {
+        if (portfolio > 0) conflict = "--portfolio";
+        else if (sim.samples > 0) conflict = "--simulate";
+        else if (diagnostics) conflict = "--diagnostics";
+        else if (stats) conflict = "--stats";
+    }
+    if (conflict) {
+        std::cerr << "Error: " << (presolve_only ? "--presolve" : "--scenarios") << " cannot be combined with "
+                  << conflict << "\n";
+        return 1;
     }
 
-    std::ostringstream buffer;
-    buffer << in.rdbuf();
-    std::string json_text = buffer.str();
+    Profiler profiler;
+    Profiler* prof = stats ? &profiler : nullptr;
+
+    // Open JSON file
+    std::string json_text;
+    {
+        ScopedTimer timer(prof, Phase::FileRead);
+        if (!read_text_file(input_path, json_text)) {
+            std::cerr << "Error: Cannot open input file: " << input_path << "\n";
+            return 2;
+        }
+    }
 
     // Parse JSON into InputModel
     Filters f;
@@ -224,15 +338,127 @@ int main(int argc, char** argv) {
     InputModel model;
 
     try {
+        ScopedTimer timer(prof, Phase::JsonParse);
         model = parse_input_json(json_text, f);
     } catch (const std::exception& e) {
         std::cerr << "Error: Failed to parse JSON: " << e.what() << "\n";
         return 3;
     }
 
-    //  Build schedule
+    // CSV name
+    if (csv_output_path.empty()) {
+        if (!unit_filter.empty()) {
+            csv_output_path = "schedule_" + unit_filter + ".csv";
+        } else {
+            csv_output_path = "schedule.csv";
+        }
+    }
+    std::string base = base_name_from_csv(csv_output_path);
+
+    // Engine options from the flags (scenarios and every scheduling mode use them)
     EngineOptions opts;
-    auto result = build_schedule(model, opts);
+    opts.diagnostics = diagnostics;
+    opts.profiler = prof;
+    opts.shift_order = shift_order;
+    opts.exact = exact;
+    opts.anneal.time_budget_ms = anneal_ms;
+    opts.anneal.seed = seed;
+
+    // Pre-solve check: bounds only, before any schedule is built
+    if (presolve_only) {
+        auto t0 = std::chrono::steady_clock::now();
+        PresolveReport report = presolve(model);
+        auto t1 = std::chrono::steady_clock::now();
+
+        std::cout << "=== Hospital Scheduler: pre-solve ===\n"
+                  << "Input: " << input_path << "\n"
+                  << "Required slots: " << report.required_slots
+                  << ", unavoidable shortfall: at least " << report.unavoidable_shortfall << "\n"
+                  << "--------------------------\n"
+                  << std::left << std::setw(12) << "role" << std::right
+                  << std::setw(8) << "staff" << std::setw(10) << "demand"
+                  << std::setw(10) << "slices" << std::setw(10) << "hours" << std::setw(12) << "shortfall" << "\n";
+        for (const auto& r : report.roles) {
+            std::cout << std::left << std::setw(12) << r.role << std::right
+                      << std::setw(8) << r.staff << std::setw(10) << r.demand
+                      << std::setw(10) << r.slice_bound << std::setw(10) << r.hours_bound
+                      << std::setw(12) << r.shortfall << "\n";
+        }
+        std::cout << "\nAnalysis took " << std::fixed << std::setprecision(1)
+                  << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms\n"
+                  << std::defaultfloat;
+
+        std::string presolve_csv = base + "_presolve.csv";
+        if (!write_presolve_csv(report, presolve_csv)) {
+            std::cerr << "Failed to write pre-solve CSV.\n";
+            return 4;
+        }
+        std::cout << "Pre-solve CSV written to: " << presolve_csv << " (" << report.slices.size()
+                  << " short slices)\n";
+        return 0;
+    }
+
+    // What-if batch: base model plus each scenario, compared side by side
+    if (!scenarios_path.empty()) {
+        std::string scenarios_text;
+        if (!read_text_file(scenarios_path, scenarios_text)) {
+            std::cerr << "Error: Cannot open scenarios file: " << scenarios_path << "\n";
+            return 2;
+        }
+        std::vector<ScenarioOverlay> overlays(1);
+        overlays[0].name = "base";
+        try {
+            for (auto& ov : parse_scenarios_json(scenarios_text, model.rules)) overlays.push_back(std::move(ov));
+        } catch (const std::exception& e) {
+            std::cerr << "Error: Failed to parse scenarios: " << e.what() << "\n";
+            return 3;
+        }
+
+        auto shared = std::make_shared<const InputModel>(std::move(model));
+        auto metrics = run_scenarios(shared, overlays, opts, threads);
+
+        std::cout << "=== Hospital Scheduler: scenarios ===\n"
+                  << "Input: " << input_path << "\n\n"
+                  << std::left << std::setw(24) << "Scenario" << std::right
+                  << std::setw(10) << "Coverage%" << std::setw(8) << "Short"
+                  << std::setw(10) << "MeanH" << std::setw(10) << "StdDevH" << std::setw(10) << "PrefViol" << std::setw(12) << "Score" << "\n";
+        for (const auto& m : metrics) {
+            std::cout << std::left << std::setw(24) << m.name << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(10) << m.coverage_pct << std::setw(8) << m.short_shifts
+                      << std::setw(10) << m.mean_hours << std::setw(10) << m.stddev_hours
+                      << std::setw(10) << m.preference_violations << std::setw(12) << m.score << "\n";
+        }
+
+        std::string scenarios_csv = base + "_scenarios.csv";
+        if (!write_scenarios_csv(metrics, scenarios_csv)) {
+            std::cerr << "Failed to write scenarios CSV.\n";
+            return 4;
+        }
+        std::cout << "\nScenarios CSV written to: " << scenarios_csv << "\n";
+        return 0;
+    }
+
+    //  Build schedule
+    if (diagnostics && !HOS_DIAGNOSTICS) {
+        std::cerr << "Warning: diagnostics were compiled out (HOS_DIAGNOSTICS=0); no report will be written.\n";
+    }
+    ScheduleResult result;
+    std::optional<PortfolioResult> best_of;
+    if (portfolio > 0) {
+        PortfolioOptions po;
+        po.passes = portfolio;
+        po.seed = seed;
+        po.threads = threads;
+        po.engine = opts;
+        best_of = run_portfolio(model, po);
+        result = std::move(best_of->best);
+    } else {
+        result = build_schedule(model, opts);
+    }
+
+    // Everything from here on is output rendering
+    std::optional<ScopedTimer> render_timer;
+    render_timer.emplace(prof, Phase::OutputRender);
 
     // Print CLI output
     std::cout << "=== Hospital Scheduler ===\n"
@@ -242,17 +468,40 @@ int main(int argc, char** argv) {
         std::cout << "Unit filter: " << unit_filter << "\n";
     }
 
+    if (best_of) {
+        std::cout << "Portfolio: pass " << best_of->best_pass << " of " << best_of->scores.size()
+                  << " is best (score " << best_of->best_score.total << ", plain pass "
+                  << best_of->scores[0].total << ")\n";
+    }
+
+    for (const auto& c : result.exact) {
+        std::cout << "Exact: role " << c.role << " (" << c.staff << " staff, " << c.shifts << " shifts): ";
+        if (!c.searched) {
+            std::cout << "too large, greedy kept\n";
+            continue;
+        }
+        std::cout << (c.improved ? "improved" : "greedy kept") << ", shortfall " << c.greedy_shortfall
+                  << " -> " << c.shortfall << ", " << c.nodes << " nodes"
+                  << (c.optimal ? ", optimal" : ", limit reached") << "\n";
+    }
+
+    if (anneal_ms > 0) {
+        const AnnealStats& a = result.anneal;
+        std::cout << "Anneal: score " << a.initial_score << " -> " << a.final_score << ", " << a.moves
+                  << " moves (" << a.accepted << " accepted) in " << a.seconds << " s\n";
+    }
+
     std::cout << "--------------------------\n\n";
 
-    for (const auto& a : result.assignments) {
-        std::cout << "Shift: " << a.shift_id << "\n";
-        if (a.staff_ids.empty()) {
+    for (size_t k = 0; k < result.shift_count(); ++k) {
+        std::cout << "Shift: " << model.shifts[result.shift_index[k]].id << "\n";
+        if (result.staff_count(k) == 0) {
             std::cout << "  Assigned: (none)\n";
         } else {
             std::cout << "  Assigned: ";
-            for (size_t i = 0; i < a.staff_ids.size(); ++i) {
-                std::cout << a.staff_ids[i];
-                if (i + 1 < a.staff_ids.size()) std::cout << ", ";
+            for (const std::uint32_t* p = result.staff_begin(k); p != result.staff_end(k); ++p) {
+                if (p != result.staff_begin(k)) std::cout << ", ";
+                std::cout << model.staff[*p].id;
             }
             std::cout << "\n";
         }
@@ -267,18 +516,11 @@ int main(int argc, char** argv) {
         std::cout << "\n";
     }
 
-    // CSV name
-    if (csv_output_path.empty()) {
-        if (!unit_filter.empty()) {
-            csv_output_path = "schedule_" + unit_filter + ".csv";
-        } else {
-            csv_output_path = "schedule.csv";
-        }
-    }
-
-    std::string base = base_name_from_csv(csv_output_path);
     std::string staff_csv    = base + "_staff.csv";
     std::string warnings_csv = base + "_warnings.csv";
+    std::string diagnostics_csv = base + "_diagnostics.csv";
+    std::string stats_json   = base + "_stats.json";
+    std::string simulation_csv = base + "_simulation.csv";
 
     // Write main schedule CSV
     if (!write_schedule_csv(model, result, csv_output_path)) {
@@ -288,8 +530,7 @@ int main(int argc, char** argv) {
     std::cout << "Schedule CSV written to: " << csv_output_path << "\n";
 
     // Write staff summary CSV
-    auto staff_hours = compute_staff_hours(model, result);
-    if (!write_staff_summary_csv(model, staff_hours, staff_csv)) {
+    if (!write_staff_summary_csv(model, result, staff_csv)) {
         std::cerr << "Failed to write staff summary CSV.\n";
         return 5;
     }
@@ -302,6 +543,55 @@ int main(int argc, char** argv) {
     }
     std::cout << "Warnings CSV written to: " << warnings_csv << "\n";
 
+    // Write diagnostics CSV
+    if (diagnostics && HOS_DIAGNOSTICS) {
+        if (!write_diagnostics_csv(result, diagnostics_csv)) {
+            std::cerr << "Failed to write diagnostics CSV.\n";
+            return 7;
+        }
+        std::cout << "Diagnostics CSV written to: " << diagnostics_csv << "\n";
+    }
+
+    // Call-out simulation against the schedule just written
+    if (sim.samples > 0) {
+        sim.threads = threads;
+        sim.seed = seed;
+        SimulationReport report = simulate_callouts(model, result, sim);
+        std::cout << "\n=== Call-out simulation ===\n"
+                  << "Samples: " << report.samples << ", call-out rate: " << sim.callout_rate
+                  << ", seed: " << sim.seed << "\n"
+                  << "Required slots: " << report.required_slots
+                  << " (already uncovered: " << report.baseline_uncovered_slots << ")\n"
+                  << std::fixed << std::setprecision(1)
+                  << "Vacated per sample:   mean " << report.vacated_slots.mean
+                  << ", p95 " << report.vacated_slots.p95 << "\n"
+                  << "Repaired per sample:  mean " << report.repaired_slots.mean
+                  << ", p95 " << report.repaired_slots.p95 << "\n"
+                  << "Uncovered per sample: mean " << report.uncovered_slots.mean
+                  << ", p95 " << report.uncovered_slots.p95 << ", max " << report.uncovered_slots.max << "\n"
+                  << std::setprecision(2)
+                  << "Coverage %:           mean " << report.coverage_pct.mean
+                  << ", p5 " << report.coverage_pct.p5 << ", min " << report.coverage_pct.min << "\n"
+                  << std::defaultfloat;
+        if (!write_simulation_csv(report, simulation_csv)) {
+            std::cerr << "Failed to write simulation CSV.\n";
+            return 9;
+        }
+        std::cout << "Simulation CSV written to: " << simulation_csv << "\n";
+    }
+
+    // Write stats JSON (stop the render timer first so it is included)
+    render_timer.reset();
+    if (stats) {
+        std::ofstream out(stats_json);
+        if (!out) {
+            std::cerr << "Error: Cannot open JSON file for writing: " << stats_json << "\n";
+            return 8;
+        }
+        out << profiler.to_json();
+        std::cout << "Stats JSON written to: " << stats_json << "\n";
+    }
+
     std::cout << "Done.\n";
     return 0;
 }
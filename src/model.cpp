@@ -0,0 +1,27 @@
+#include "model.hpp"
+#include <algorithm>
+
+std::vector<std::uint32_t> unique_shift_order(const std::vector<Shifts>& shifts) {
+    // Intern ids (views into the shifts, nothing copied); keep the first occurrence
+    std::unordered_map<std::string_view, std::uint32_t> first_by_id;
+    first_by_id.reserve(shifts.size());
+
+    std::vector<std::uint32_t> order;
+    order.reserve(shifts.size());
+    for (std::uint32_t i = 0; i < shifts.size(); ++i) {
+        if (first_by_id.emplace(shifts[i].id, i).second) order.push_back(i);
+    }
+
+    // Sort the permutation by start; ties keep input order so runs are deterministic
+    std::vector<SysTime::rep> start(shifts.size());
+    for (std::uint32_t i : order) start[i] = shifts[i].start.time_since_epoch().count();
+    std::sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+        return start[a] != start[b] ? start[a] < start[b] : a < b;
+    });
+
+    return order;
+}
+
+void index_shifts(InputModel& model) {
+    model.shift_order = unique_shift_order(model.shifts);
+}
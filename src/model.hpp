@@ -4,10 +4,14 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <chrono>
+#include <cstdint>
+#include <string_view>
+#include "civil_time.hpp"
 
 using Clock = std::chrono::system_clock;
 using SysTime = std::chrono::time_point<Clock>;
 using Hours = std::chrono::hours;
+using Minutes = std::chrono::minutes;
 
 // Helpers
 struct DateStamp {
@@ -22,36 +26,29 @@ inline bool operator==(const DateStamp& a, const DateStamp& b) {
     return a.y==b.y && a.m==b.m && a.d==b.d;
 }
 
-// Parser for "YYYY-MM-DD"
-inline bool parse_date(const std::string& s, DateStamp& out) {
+// Parser for "YYYY-MM-DD" (fixed width, no allocation)
+inline bool parse_date(std::string_view s, DateStamp& out) {
     if (s.size() != 10 || s[4]!='-' || s[7]!='-') return false;
-    out.y = std::stoi(s.substr(0,4));
-    out.m = std::stoi(s.substr(5,2));
-    out.d = std::stoi(s.substr(8,2));
-    return true;
+    bool ok = parse_fixed_digits<4>(s.data(), out.y) &
+              parse_fixed_digits<2>(s.data() + 5, out.m) &
+              parse_fixed_digits<2>(s.data() + 8, out.d);
+    return ok && out.m >= 1 && out.m <= 12 && out.d >= 1 && out.d <= 31;
 }
-// Parser for "YYY-MM-DDTHH:MM"
-inline bool parse_datetime(const std::string& s, DateTimeStamp& out) {
+// Parser for "YYYY-MM-DDTHH:MM" (fixed width, no allocation)
+inline bool parse_datetime(std::string_view s, DateTimeStamp& out) {
     if (s.size() != 16 || s[4]!='-' || s[7]!='-' || s[10] != 'T' || s[13] != ':') return false;
-    out.y = std::stoi(s.substr(0,4));
-    out.m = std::stoi(s.substr(5,2));
-    out.d = std::stoi(s.substr(8,2));
-    out.H = std::stoi(s.substr(11,2));
-    out.M = std::stoi(s.substr(14,2));
-    return true;
+    bool ok = parse_fixed_digits<4>(s.data(), out.y) &
+              parse_fixed_digits<2>(s.data() + 5, out.m) &
+              parse_fixed_digits<2>(s.data() + 8, out.d) &
+              parse_fixed_digits<2>(s.data() + 11, out.H) &
+              parse_fixed_digits<2>(s.data() + 14, out.M);
+    return ok && out.m >= 1 && out.m <= 12 && out.d >= 1 && out.d <= 31;
 }
 
-// Convert DateTimeStamp to a rough time_point
+// Convert local DateTimeStamp to a time_point (hours/minutes past the day normalize like mktime)
 inline SysTime to_time_point(const DateTimeStamp& dt) {
-    std::tm tm{};
-    tm.tm_year = dt.y - 1900;
-    tm.tm_mon  = dt.m - 1;
-    tm.tm_mday = dt.d;
-    tm.tm_hour = dt.H;
-    tm.tm_min  = dt.M;
-    tm.tm_sec  = 0;
-    auto t = std::mktime(&tm); // local
-    return Clock::from_time_t(t);
+    auto t = local_to_utc_seconds(dt.y, dt.m, dt.d, dt.H, dt.M); // cached offsets, see civil_time.hpp
+    return Clock::from_time_t(static_cast<std::time_t>(t));
 }
 
 inline DateStamp to_date(const DateTimeStamp& dt) { 
@@ -92,27 +89,41 @@ struct Shifts {
     std::string id;
     std::string name; // Unit
     std::string req_role;
+    std::vector<std::string> req_skills; // every one needed (checked with the "skills" constraint)
     short required_count = 1; // default  
     SysTime start;
     SysTime end;
 
     // Time tracking
-    Hours duration() const { // Length of shift
+    Hours duration() const { // Length of shift (whole hours, truncated)
         return std::chrono::duration_cast<Hours>(end - start);
     }
-    DateStamp day() const { // Reconstruct of the day
+    Minutes duration_minutes() const { // Exact length of shift
+        return std::chrono::duration_cast<Minutes>(end - start);
+    }
+    DateStamp day() const { // Reconstruct of the day (localtime_r: safe from several threads)
         std::time_t tt = Clock::to_time_t(start);
-        std::tm* tm = std::localtime(&tt);
-        return {tm->tm_year+1900, tm->tm_mon+1, tm->tm_mday};
+        std::tm tm{};
+        localtime_r(&tt, &tm);
+        return {tm.tm_year+1900, tm.tm_mon+1, tm.tm_mday};
     }
     bool is_night() const { // Is it night (Naive: Night if shift starts after 12pm)
         std::time_t tt = Clock::to_time_t(start);
-        std::tm* tm = std::localtime(&tt);
-        return (tm->tm_hour >= 12);
+        std::tm tm{};
+        localtime_r(&tt, &tm);
+        return (tm.tm_hour >= 12);
     }
 };
 
 
+// Weights of the schedule objective (score.hpp; lower is better)
+struct ObjectiveWeights {
+    double shortfall = 1000.0;    // per required slot left unfilled
+    double hours_variance = 1.0;  // per hour^2 of variance in assigned hours across staff
+    double preference = 10.0;     // per assignment that breaks a staff preference
+    double night_variance = 0.0;  // per unit of variance in night shifts across staff
+};
+
 struct Rules {
     // shorts to save some memory since doesnt exceed 32k
     short max_hours_per_week_default = 40; // default weekly hour limit
@@ -120,10 +131,27 @@ struct Rules {
     short min_rest_hours_default = 12; // default limit for rest between shifts
     std::unordered_set<std::string> hard_constraints; // Covereage, legal limits, Needs
     std::unordered_set<std::string> soft_constraints; // preferences, fairness
+    ObjectiveWeights objective; // "objective_weights": how schedules are scored
 };
 
 struct InputModel {
     std::vector<Staff> staff; // List of staff for schedules
     std::vector<Shifts> shifts; // List of shifts needed/available
     Rules rules; // Rules for the engine (Like max hours, preference, coverage)
+    // Indices into shifts: first occurrence of each id, sorted by start (then input order).
+    // Filled by the parser; call index_shifts() again after editing shifts.
+    std::vector<std::uint32_t> shift_order;
 };
+
+// Unique shifts (first occurrence per id) ordered by start time, as indices into shifts
+std::vector<std::uint32_t> unique_shift_order(const std::vector<Shifts>& shifts);
+
+// Recompute model.shift_order
+void index_shifts(InputModel& model);
+
+// model.shift_order, or `scratch` filled with a fresh order if the model was never indexed
+inline const std::vector<std::uint32_t>& shift_order_of(const InputModel& model, std::vector<std::uint32_t>& scratch) {
+    if (!model.shift_order.empty() || model.shifts.empty()) return model.shift_order;
+    scratch = unique_shift_order(model.shifts);
+    return scratch;
+}
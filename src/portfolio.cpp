@@ -0,0 +1,63 @@
+#include "portfolio.hpp"
+#include "rng.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+
+PortfolioResult run_portfolio(const InputModel& model, const PortfolioOptions& opt) {
+    PortfolioResult out;
+    const unsigned passes = std::max(1u, opt.passes);
+    out.scores.resize(passes);
+
+    // Shared by every pass: same staff and units
+    const PenaltyTable penalties = build_penalty_table(model);
+    const ObjectiveWeights weights = opt.weights.value_or(model.rules.objective);
+
+    // Each thread keeps its own best; the final pick compares (score, pass), so the
+    // winner is the same whichever thread ran which pass
+    struct Best {
+        bool set = false;
+        unsigned pass = 0;
+        ScheduleResult result;
+    };
+    auto better = [&](unsigned a, unsigned b) {
+        return out.scores[a].total != out.scores[b].total ? out.scores[a].total < out.scores[b].total : a < b;
+    };
+
+    std::atomic<unsigned> next{0};
+    auto worker = [&](Best& best) {
+        for (unsigned p = next.fetch_add(1); p < passes; p = next.fetch_add(1)) {
+            EngineOptions eo = opt.engine;
+            eo.profiler = nullptr; // Profiler is per thread
+            eo.penalties = &penalties;
+            eo.tie_seed = p == 0 ? 0 : splitmix64(opt.seed ^ splitmix64(p)) | 1; // never 0 after pass 0
+            ScheduleResult r = build_schedule(model, eo);
+            out.scores[p] = score_schedule(model, r, weights);
+            if (!best.set || better(p, best.pass)) {
+                best.set = true;
+                best.pass = p;
+                best.result = std::move(r);
+            }
+        }
+    };
+
+    unsigned threads = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, passes);
+    std::vector<Best> bests(threads);
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker, std::ref(bests[t]));
+    worker(bests[0]); // this thread works too
+    for (auto& th : pool) th.join();
+
+    Best* winner = nullptr;
+    for (auto& b : bests) {
+        if (b.set && (!winner || better(b.pass, winner->pass))) winner = &b;
+    }
+    out.best_pass = winner->pass;
+    out.best_score = out.scores[winner->pass];
+    out.best = std::move(winner->result);
+    return out;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "model.hpp"
+#include "engine.hpp"
+#include "score.hpp"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Multi-start greedy: the same engine run several times with seeded tie-breaking,
+// keeping the schedule with the best objective (score_schedule, score.hpp).
+
+struct PortfolioOptions {
+    unsigned passes = 16;       // pass 0 is the plain deterministic schedule
+    std::uint64_t seed = 1;     // tie seeds of passes 1.. derive from this
+    unsigned threads = 0;       // 0: one per core; the result does not depend on it
+    std::optional<ObjectiveWeights> weights; // default: the input's Rules::objective; terms of soft
+                                             // constraints the rules turn off are not counted
+    EngineOptions engine;       // tie_seed is set per pass; profiler is ignored
+};
+
+struct PortfolioResult {
+    ScheduleResult best;
+    unsigned best_pass = 0;
+    ScheduleScore best_score;
+    std::vector<ScheduleScore> scores; // one per pass
+};
+
+// Run every pass and keep the lowest total score (the lowest pass index on ties)
+PortfolioResult run_portfolio(const InputModel& model, const PortfolioOptions& opt = PortfolioOptions{});
@@ -0,0 +1,212 @@
+#include "presolve.hpp"
+#include "constraints.hpp"
+#include "eligibility.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+
+namespace {
+
+using Minute = std::int64_t;
+
+// Max b-matching of workers to shifts (each worker at most one shift, shift i at most
+// cap[i] workers) by augmenting paths. adj[w] lists the shifts worker w may take.
+class SliceMatching {
+public:
+    long run(const std::vector<std::vector<std::uint32_t>>& adj, const std::vector<long>& cap) {
+        adj_ = &adj;
+        cap_ = &cap;
+        taken_.assign(cap.size(), {});
+        long matched = 0;
+        long demand = 0;
+        for (long c : cap) demand += c;
+        for (std::uint32_t w = 0; w < adj.size() && matched < demand; ++w) {
+            seen_.assign(cap.size(), 0);
+            matched += augment(w);
+        }
+        return matched;
+    }
+
+private:
+    bool augment(std::uint32_t w) {
+        for (std::uint32_t s : (*adj_)[w]) {
+            if (seen_[s]) continue;
+            seen_[s] = 1;
+            if (static_cast<long>(taken_[s].size()) < (*cap_)[s]) {
+                taken_[s].push_back(w);
+                return true;
+            }
+            for (auto& other : taken_[s]) {
+                if (augment(other)) {
+                    other = w;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    const std::vector<std::vector<std::uint32_t>>* adj_ = nullptr;
+    const std::vector<long>* cap_ = nullptr;
+    std::vector<std::vector<std::uint32_t>> taken_;
+    std::vector<std::uint8_t> seen_;
+};
+
+} // namespace
+
+PresolveReport presolve(const InputModel& model) {
+    PresolveReport report;
+    // Unique shifts in start order, grouped by role (roles no one has included)
+    std::vector<std::uint32_t> order_scratch;
+    const auto& order = shift_order_of(model, order_scratch);
+    std::map<std::string, std::vector<std::uint32_t>> shifts_of;   // role -> shift indices
+    std::map<std::string, std::vector<std::uint32_t>> members_of;  // role -> staff indices
+    for (std::uint32_t idx : order) shifts_of[model.shifts[idx].req_role].push_back(idx);
+    for (std::uint32_t w = 0; w < model.staff.size(); ++w) members_of[model.staff[w].role].push_back(w);
+
+    // Eligibility as the engine checks it; pos_of maps a shift index to its kernel position
+    const EligibilityKernel kernel(model, order, select_constraints(model.rules).hard);
+    const bool check_skills = (kernel.hard() & constraint::skills) != 0;
+    const bool check_hours = (kernel.hard() & constraint::weekly_hours) != 0;
+    const bool check_rest = (kernel.hard() & constraint::rest) != 0;
+    std::vector<std::uint32_t> pos_of(model.shifts.size(), 0);
+    for (std::uint32_t k = 0; k < order.size(); ++k) pos_of[order[k]] = k;
+
+    auto minutes_of = [](const Shifts& sh) { return static_cast<Minute>(sh.duration_minutes().count()); };
+    // Everything but rest and the hours already worked (role matches within a role group)
+    auto eligible = [&](std::uint32_t w, std::uint32_t idx) { return kernel.static_ok(w, pos_of[idx]); };
+
+    SliceMatching matching;
+    std::vector<std::vector<std::uint32_t>> adj;
+    std::vector<long> cap;
+    std::vector<std::uint32_t> slice_shifts;
+
+    for (const auto& [role, shift_list] : shifts_of) {
+        static const std::vector<std::uint32_t> no_staff;
+        auto m = members_of.find(role);
+        const std::vector<std::uint32_t>& members = m != members_of.end() ? m->second : no_staff;
+
+        PresolveRole pr;
+        pr.role = role;
+        pr.staff = members.size();
+
+        // Two shifts closer than this gap can't go to one worker
+        Minute gap = 0;
+        if (check_rest && !members.empty()) {
+            gap = Minute{model.staff[members[0]].min_rest};
+            for (std::uint32_t w : members) gap = std::min(gap, Minute{model.staff[w].min_rest});
+            gap *= 60;
+        }
+
+        // Cheap candidate counts: members minus those off that day or capped below the shift
+        std::vector<long> off_on_day(static_cast<size_t>(kernel.day_count()), 0); // kernel day -> members unavailable
+        std::vector<Minute> caps;                                                 // member caps in minutes, sorted
+        for (std::uint32_t w : members) {
+            if (!model.staff[w].availability.empty()) {
+                for (std::int32_t d = 0; d < kernel.day_count(); ++d) off_on_day[static_cast<size_t>(d)] += !kernel.available(w, d);
+            }
+            if (check_hours) caps.push_back(Minute{model.staff[w].max_weekly_hours} * 60);
+        }
+        std::sort(caps.begin(), caps.end());
+        auto candidates_for = [&](std::uint32_t idx) {
+            const Shifts& sh = model.shifts[idx];
+            if (check_skills && !sh.req_skills.empty()) {
+                long n = 0;
+                for (std::uint32_t w : members) n += eligible(w, idx);
+                return n;
+            }
+            long n = static_cast<long>(members.size()) - off_on_day[static_cast<size_t>(kernel.shift_day(pos_of[idx]))];
+            // Staff off that day and capped below the shift are both subtracted: an undercount,
+            // which only makes the slice look tight and the exact matching decides
+            n -= std::lower_bound(caps.begin(), caps.end(), minutes_of(sh)) - caps.begin();
+            return n;
+        };
+
+        // Hours: required minutes beyond the sum of caps, in units of the longest shift
+        Minute demand_minutes = 0, longest = 0;
+        for (std::uint32_t idx : shift_list) {
+            const Shifts& sh = model.shifts[idx];
+            if (sh.required_count <= 0) continue;
+            pr.demand += sh.required_count;
+            demand_minutes += Minute{sh.required_count} * minutes_of(sh);
+            longest = std::max(longest, minutes_of(sh));
+        }
+        if (check_hours && longest > 0) {
+            Minute capacity = 0;
+            for (std::uint32_t w : members) capacity += Minute{model.staff[w].max_weekly_hours} * 60;
+            const Minute excess = demand_minutes - capacity;
+            if (excess > 0) pr.hours_bound = static_cast<long>((excess + longest - 1) / longest);
+        }
+
+        // Slices: sweep in start order, growing a slice while every shift's [start, end + gap)
+        // still shares a point with the others; the slices are disjoint, so their bounds add.
+        // Without the rest rule one worker may take overlapping shifts, so each shift is a
+        // slice of its own
+        auto close_slice = [&]() {
+            if (slice_shifts.empty()) return;
+            long demand = 0;
+            for (std::uint32_t idx : slice_shifts) demand += std::max<long>(model.shifts[idx].required_count, 0);
+            if (demand == 0) return;
+
+            // Hall's condition holds when every shift alone has as many candidates as the
+            // whole slice needs; only slices where it may fail get the exact matching
+            bool tight = false;
+            for (std::uint32_t idx : slice_shifts) {
+                const Shifts& sh = model.shifts[idx];
+                if (sh.required_count > 0 && candidates_for(idx) < demand) {
+                    tight = true;
+                    break;
+                }
+            }
+            long supply = demand;
+            if (tight) {
+                adj.assign(members.size(), {});
+                cap.assign(slice_shifts.size(), 0);
+                for (std::uint32_t i = 0; i < slice_shifts.size(); ++i) {
+                    cap[i] = std::max<long>(model.shifts[slice_shifts[i]].required_count, 0);
+                    if (cap[i] == 0) continue;
+                    for (std::uint32_t j = 0; j < members.size(); ++j) {
+                        if (eligible(members[j], slice_shifts[i])) adj[j].push_back(i);
+                    }
+                }
+                supply = matching.run(adj, cap);
+            }
+            if (supply < demand) {
+                PresolveSlice ps;
+                ps.role = role;
+                ps.start = model.shifts[slice_shifts.front()].start;
+                ps.end = model.shifts[slice_shifts.front()].end;
+                for (std::uint32_t idx : slice_shifts) ps.end = std::max(ps.end, model.shifts[idx].end);
+                ps.shifts = slice_shifts.size();
+                ps.demand = demand;
+                ps.supply = supply;
+                ps.shortfall = demand - supply;
+                pr.slice_bound += ps.shortfall;
+                report.slices.push_back(ps);
+            }
+        };
+
+        slice_shifts.clear();
+        SysTime slice_end{}; // the slice's shifts all cover [last start, slice_end)
+        for (std::uint32_t idx : shift_list) {
+            const Shifts& sh = model.shifts[idx];
+            const SysTime reach = sh.end + std::chrono::minutes(gap);
+            if (check_rest && !slice_shifts.empty() && sh.start < slice_end) {
+                slice_shifts.push_back(idx);
+                slice_end = std::min(slice_end, reach);
+            } else {
+                close_slice();
+                slice_shifts.assign(1, idx);
+                slice_end = reach;
+            }
+        }
+        close_slice();
+
+        pr.shortfall = std::max(pr.slice_bound, pr.hours_bound);
+        report.required_slots += pr.demand;
+        report.unavoidable_shortfall += pr.shortfall;
+        report.roles.push_back(pr);
+    }
+    return report;
+}
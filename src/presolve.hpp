@@ -0,0 +1,41 @@
+#pragma once
+#include "model.hpp"
+#include <string>
+#include <vector>
+
+// Pre-solve analysis: lower bounds on the shortfall any schedule must have under the
+// rules' hard constraints, computed without scheduling. Roles are independent (staff
+// have one role, shifts need one), so every bound is per role.
+
+// A set of shifts no single worker can take two of (they overlap, or are closer than
+// the role's shortest rest), with fewer eligible staff than required slots. Without the
+// rest rule a worker may take any two, so each slice is a single shift
+struct PresolveSlice {
+    std::string role;
+    SysTime start;       // earliest start of its shifts
+    SysTime end;         // latest end
+    size_t shifts = 0;
+    long demand = 0;     // required slots
+    long supply = 0;     // most slots eligible staff can fill at once (matching)
+    long shortfall = 0;  // demand - supply
+};
+
+struct PresolveRole {
+    std::string role;
+    size_t staff = 0;
+    long demand = 0;        // required slots
+    long slice_bound = 0;   // sum of shortfalls over disjoint slices
+    long hours_bound = 0;   // required minutes beyond the staff's hour caps, in longest shifts
+    long shortfall = 0;     // the larger of the two
+};
+
+struct PresolveReport {
+    long required_slots = 0;
+    long unavoidable_shortfall = 0;    // sum over roles
+    std::vector<PresolveRole> roles;   // by role name
+    std::vector<PresolveSlice> slices; // only those with a shortfall, in start order per role
+};
+
+// Bounds hold for the role, availability, skills, weekly_hours and rest constraints the
+// rules select; consecutive days are not counted (the bound only gets looser)
+PresolveReport presolve(const InputModel& model);
@@ -0,0 +1,57 @@
+#include "profiler.hpp"
+#include <sstream>
+
+const char* phase_name(Phase p) {
+    switch (p) {
+        case Phase::FileRead:        return "file_read";
+        case Phase::JsonParse:       return "json_parse";
+        case Phase::ShiftDedup:      return "shift_dedup_sort";
+        case Phase::CandidateFilter: return "candidate_filter";
+        case Phase::CandidateRank:   return "candidate_rank";
+        case Phase::OutputRender:    return "output_render";
+        case Phase::Count:           break;
+    }
+    return "unknown";
+}
+
+const char* counter_name(Counter c) {
+    switch (c) {
+        case Counter::CandidatesExamined: return "candidates_examined";
+        case Counter::CandidatesEligible: return "candidates_eligible";
+        case Counter::CoverageShort:      return "coverage_short";
+        case Counter::Count:              break;
+    }
+    return "unknown";
+}
+
+std::string Profiler::to_json() const {
+    std::ostringstream out;
+    out << "{\n  \"profiling_enabled\": " << (HOS_PROFILING != 0 ? "true" : "false") << ",\n";
+
+    // Phases
+    out << "  \"phases\": {";
+    for (int i = 0; i < static_cast<int>(Phase::Count); ++i) {
+        const auto& ph = phases_[i];
+        out << (i ? ",\n" : "\n")
+            << "    \"" << phase_name(static_cast<Phase>(i)) << "\": {"
+            << "\"ms\": " << static_cast<double>(ph.ns) / 1e6 << ", "
+            << "\"calls\": " << ph.calls << "}";
+    }
+    out << "\n  },\n";
+
+    // Counters
+    out << "  \"counters\": {";
+    for (int i = 0; i < static_cast<int>(Counter::Count); ++i) {
+        const auto& ct = counters_[i];
+        double mean = ct.samples ? static_cast<double>(ct.total) / static_cast<double>(ct.samples) : 0.0;
+        out << (i ? ",\n" : "\n")
+            << "    \"" << counter_name(static_cast<Counter>(i)) << "\": {"
+            << "\"total\": " << ct.total << ", "
+            << "\"samples\": " << ct.samples << ", "
+            << "\"mean\": " << mean << ", "
+            << "\"max\": " << ct.max << "}";
+    }
+    out << "\n  }\n}\n";
+
+    return out.str();
+}
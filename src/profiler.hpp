@@ -0,0 +1,98 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Phase timers and counters are compiled in by default; build with -DHOS_PROFILING=0 to strip them
+#ifndef HOS_PROFILING
+#define HOS_PROFILING 1
+#endif
+
+// Timed phases of one scheduler run
+enum class Phase {
+    FileRead,
+    JsonParse,
+    ShiftDedup,
+    CandidateFilter,
+    CandidateRank,
+    OutputRender,
+    Count
+};
+
+// Per-shift counters (each sample is one shift)
+enum class Counter {
+    CandidatesExamined,
+    CandidatesEligible,
+    CoverageShort,
+    Count
+};
+
+const char* phase_name(Phase p);
+const char* counter_name(Counter c);
+
+// Collects phase times and counters for one run (not thread-safe, use one per thread)
+class Profiler {
+public:
+    void add_time(Phase p, std::chrono::nanoseconds d) {
+        if constexpr (HOS_PROFILING != 0) {
+            auto& ph = phases_[static_cast<int>(p)];
+            ph.ns += static_cast<std::uint64_t>(d.count());
+            ++ph.calls;
+        }
+    }
+
+    void count(Counter c, std::uint64_t value) {
+        if constexpr (HOS_PROFILING != 0) {
+            auto& ct = counters_[static_cast<int>(c)];
+            ct.total += value;
+            ++ct.samples;
+            if (value > ct.max) ct.max = value;
+        }
+    }
+
+    // Stats as a JSON object (phase times in milliseconds)
+    std::string to_json() const;
+
+private:
+    struct PhaseStats {
+        std::uint64_t ns = 0;
+        std::uint64_t calls = 0;
+    };
+    struct CounterStats {
+        std::uint64_t total = 0;
+        std::uint64_t samples = 0;
+        std::uint64_t max = 0;
+    };
+
+    PhaseStats phases_[static_cast<int>(Phase::Count)]{};
+    CounterStats counters_[static_cast<int>(Counter::Count)]{};
+};
+
+// RAII timer adding its lifetime to a phase; a null profiler makes it a no-op
+class ScopedTimer {
+public:
+    ScopedTimer(Profiler* prof, Phase phase) {
+        if constexpr (HOS_PROFILING != 0) {
+            prof_ = prof;
+            phase_ = phase;
+            if (prof_) start_ = std::chrono::steady_clock::now();
+        } else {
+            (void)prof;
+            (void)phase;
+        }
+    }
+
+    ~ScopedTimer() {
+        if constexpr (HOS_PROFILING != 0) {
+            if (prof_) prof_->add_time(phase_, std::chrono::steady_clock::now() - start_);
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Profiler* prof_ = nullptr;
+    Phase phase_ = Phase::Count;
+    std::chrono::steady_clock::time_point start_{};
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+
+// Small deterministic random numbers (same sequence on every platform and standard
+// library, unlike std::shuffle over the <random> engines)
+
+// One splitmix64 step: a good 64-bit mix of x, also usable as a counter-based hash
+constexpr std::uint64_t splitmix64(std::uint64_t x) noexcept {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Sequential generator over splitmix64
+class SplitMix64 {
+public:
+    explicit SplitMix64(std::uint64_t seed) : state_(seed) {}
+
+    std::uint64_t next() {
+        const std::uint64_t x = state_;
+        state_ += 0x9E3779B97F4A7C15ull;
+        return splitmix64(x);
+    }
+
+    // Uniform in [0, n) for n > 0 (multiply-shift; bias is negligible for n << 2^32)
+    std::uint32_t below(std::uint32_t n) {
+        return static_cast<std::uint32_t>(((next() >> 32) * n) >> 32);
+    }
+
+    // Uniform in [0, 1) with 53 random bits
+    double uniform() {
+        return static_cast<double>(next() >> 11) * 0x1.0p-53;
+    }
+
+    // Fisher-Yates over [first, last)
+    template <class It>
+    void shuffle(It first, It last) {
+        for (auto n = last - first; n > 1; --n) {
+            std::swap(first[n - 1], first[below(static_cast<std::uint32_t>(n))]);
+        }
+    }
+
+private:
+    std::uint64_t state_;
+};
@@ -0,0 +1,91 @@
+#include "scenario.hpp"
+#include "score.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+std::shared_ptr<const InputModel> apply_overlay(const std::shared_ptr<const InputModel>& base,
+                                                const ScenarioOverlay& overlay) {
+    if (!overlay.changes_model()) return base; // nothing to copy
+
+    auto model = std::make_shared<InputModel>(*base);
+    if (overlay.max_weekly_hours) {
+        for (auto& s : model->staff) s.max_weekly_hours = *overlay.max_weekly_hours;
+    }
+    model->staff.insert(model->staff.end(), overlay.extra_staff.begin(), overlay.extra_staff.end());
+    if (!overlay.closed_units.empty()) {
+        auto closed = [&](const Shifts& sh) { return overlay.closed_units.count(sh.name) != 0; };
+        model->shifts.erase(std::remove_if(model->shifts.begin(), model->shifts.end(), closed), model->shifts.end());
+        index_shifts(*model);
+    }
+    return model;
+}
+
+ScenarioMetrics measure_schedule(const InputModel& model, const ScheduleResult& result) {
+    const ScheduleScore sc = score_schedule(model, result);
+    ScenarioMetrics m;
+    m.staff = model.staff.size();
+    m.shifts = result.shift_count();
+    m.warnings = result.warnings.size();
+    m.required_slots = sc.required_slots;
+    m.filled_slots = sc.filled_slots;
+    m.short_shifts = sc.short_shifts;
+    m.coverage_pct = m.required_slots ? 100.0 * static_cast<double>(m.filled_slots) / static_cast<double>(m.required_slots)
+                                      : 100.0;
+    m.mean_hours = sc.mean_hours;
+    m.stddev_hours = std::sqrt(sc.hours_variance);
+    m.min_hours = sc.min_hours;
+    m.max_hours = sc.max_hours;
+    m.preference_violations = sc.preference_violations;
+    m.stddev_nights = std::sqrt(sc.night_variance);
+    m.score = sc.total;
+    return m;
+}
+
+std::vector<ScenarioMetrics> run_scenarios(const std::shared_ptr<const InputModel>& base,
+                                           const std::vector<ScenarioOverlay>& overlays,
+                                           const EngineOptions& base_options, unsigned threads) {
+    std::vector<ScenarioMetrics> out(overlays.size());
+    if (overlays.empty()) return out;
+
+    // One penalty table for every scenario that keeps the base staff list. Closing units
+    // only drops columns and an hour cap is not a preference, so only added staff need
+    // their own table; that is decided here once rather than re-hashed in every run.
+    const PenaltyTable base_penalties = build_penalty_table(*base);
+
+    // Workers take the next scenario index; each writes only its own slot
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+        for (size_t i = next.fetch_add(1); i < overlays.size(); i = next.fetch_add(1)) {
+            const ScenarioOverlay& ov = overlays[i];
+            std::shared_ptr<const InputModel> model = apply_overlay(base, ov);
+
+            EngineOptions opt = base_options;
+            opt.profiler = nullptr; // Profiler is per thread; scenarios only report metrics
+            opt.penalties = ov.extra_staff.empty() ? &base_penalties : nullptr;
+            if (ov.fairness_on) opt.fairness_on = *ov.fairness_on;
+            if (ov.respect_preferences) opt.respect_preferences = *ov.respect_preferences;
+
+            auto t0 = std::chrono::steady_clock::now();
+            ScheduleResult result = build_schedule(*model, opt);
+            auto t1 = std::chrono::steady_clock::now();
+
+            out[i] = measure_schedule(*model, result);
+            out[i].name = ov.name;
+            out[i].elapsed_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        }
+    };
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, overlays.size()));
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker(); // this thread works too
+    for (auto& th : pool) th.join();
+    return out;
+}
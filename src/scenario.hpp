@@ -0,0 +1,56 @@
+#pragma once
+#include "model.hpp"
+#include "engine.hpp"
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// What-if runs: one parsed base model, many small variations scheduled in parallel.
+
+// Changes a scenario makes on top of the base model (unset fields keep the base)
+struct ScenarioOverlay {
+    std::string name;
+    std::optional<bool> fairness_on;
+    std::optional<bool> respect_preferences;
+    std::optional<short> max_weekly_hours;         // cap for every staff member
+    std::vector<Staff> extra_staff;                // e.g. agency staff
+    std::unordered_set<std::string> closed_units;  // shifts in these units are dropped
+
+    bool changes_model() const { return max_weekly_hours || !extra_staff.empty() || !closed_units.empty(); }
+};
+
+// Coverage and fairness of one scenario's schedule
+struct ScenarioMetrics {
+    std::string name;
+    size_t staff = 0;
+    size_t shifts = 0;            // unique shifts scheduled
+    long required_slots = 0;
+    long filled_slots = 0;
+    size_t short_shifts = 0;      // shifts with fewer staff than required
+    double coverage_pct = 0;      // filled / required slots
+    double mean_hours = 0;        // assigned hours per staff member
+    double stddev_hours = 0;
+    double min_hours = 0;
+    double max_hours = 0;
+    long preference_violations = 0;
+    double stddev_nights = 0;     // night shifts per staff member
+    double score = 0;             // score_schedule total with the model's weights
+    size_t warnings = 0;
+    double elapsed_ms = 0;        // build_schedule wall time
+};
+
+// The model a scenario runs on: `base` itself if only options change, else a modified copy
+// (the base is shared read-only between threads and never written)
+std::shared_ptr<const InputModel> apply_overlay(const std::shared_ptr<const InputModel>& base,
+                                                const ScenarioOverlay& overlay);
+
+// Metrics of a finished schedule
+ScenarioMetrics measure_schedule(const InputModel& model, const ScheduleResult& result);
+
+// Run every overlay (threads = 0: one per core). Results keep the overlay order.
+std::vector<ScenarioMetrics> run_scenarios(const std::shared_ptr<const InputModel>& base,
+                                           const std::vector<ScenarioOverlay>& overlays,
+                                           const EngineOptions& base_options = EngineOptions{},
+                                           unsigned threads = 0);
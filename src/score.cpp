@@ -0,0 +1,53 @@
+#include "score.hpp"
+#include "constraints.hpp"
+
+#include <algorithm>
+
+ObjectiveWeights selected_weights(const Rules& rules, ObjectiveWeights weights) {
+    const ConstraintSelection sel = select_constraints(rules);
+    if (!sel.fairness) weights.hours_variance = 0;
+    if (!sel.preferences) weights.preference = 0;
+    return weights;
+}
+
+ScheduleScore score_schedule(const InputModel& model, const ScheduleResult& result, const ObjectiveWeights& objective) {
+    const ObjectiveWeights weights = selected_weights(model.rules, objective);
+    ScheduleScore s;
+    for (size_t k = 0; k < result.shift_count(); ++k) {
+        const long required = std::max<long>(model.shifts[result.shift_index[k]].required_count, 0);
+        const long filled = static_cast<long>(result.staff_offsets[k + 1] - result.staff_offsets[k]);
+        s.required_slots += required;
+        s.filled_slots += std::min(filled, required);
+        if (filled < required) ++s.short_shifts;
+    }
+    s.shortfall_slots = s.required_slots - s.filled_slots;
+
+    if (!result.staff_totals.empty()) {
+        // Minutes and nights are integers: exact sums, one division at the end
+        std::int64_t minutes = 0, minutes_sq = 0, nights = 0, nights_sq = 0;
+        std::int32_t min_minutes = result.staff_totals[0].minutes, max_minutes = min_minutes;
+        for (const auto& t : result.staff_totals) {
+            minutes += t.minutes;
+            minutes_sq += std::int64_t{t.minutes} * t.minutes;
+            nights += t.nights;
+            nights_sq += std::int64_t{t.nights} * t.nights;
+            min_minutes = std::min(min_minutes, t.minutes);
+            max_minutes = std::max(max_minutes, t.minutes);
+            s.max_nights = std::max<long>(s.max_nights, t.nights);
+            s.preference_violations += t.preference_violations;
+        }
+        const double n = static_cast<double>(result.staff_totals.size());
+        const double mean_minutes = static_cast<double>(minutes) / n;
+        s.mean_hours = mean_minutes / 60.0;
+        s.hours_variance = std::max(0.0, static_cast<double>(minutes_sq) / n - mean_minutes * mean_minutes) / 3600.0;
+        s.min_hours = min_minutes / 60.0;
+        s.max_hours = max_minutes / 60.0;
+        s.mean_nights = static_cast<double>(nights) / n;
+        s.night_variance = std::max(0.0, static_cast<double>(nights_sq) / n - s.mean_nights * s.mean_nights);
+    }
+    s.total = weights.shortfall * static_cast<double>(s.shortfall_slots) +
+              weights.hours_variance * s.hours_variance +
+              weights.preference * static_cast<double>(s.preference_violations) +
+              weights.night_variance * s.night_variance;
+    return s;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "model.hpp"
+#include "engine.hpp"
+
+// Weighted objective of a finished schedule, shared by the portfolio, anneal mode and
+// what-if scenarios. One pass over the flat shift entries and one over the staff totals;
+// nothing is re-derived from the model beyond each shift's required count.
+
+// Every term of the objective, plus the summaries the terms come from
+struct ScheduleScore {
+    long required_slots = 0;
+    long filled_slots = 0;          // up to the requirement of each shift
+    long shortfall_slots = 0;
+    size_t short_shifts = 0;        // shifts with fewer staff than required
+    double mean_hours = 0;          // assigned hours per staff member
+    double hours_variance = 0;
+    double min_hours = 0;
+    double max_hours = 0;           // max - min is the fairness spread
+    long preference_violations = 0;
+    double mean_nights = 0;         // night shifts per staff member
+    double night_variance = 0;
+    long max_nights = 0;
+    double total = 0;               // weighted sum (lower is better)
+};
+
+// `weights` without the terms of soft constraints the rules turn off: hours_variance
+// when "fairness" is not selected, preference when "preferences" is not
+ObjectiveWeights selected_weights(const Rules& rules, ObjectiveWeights weights);
+
+// Score with explicit weights (masked by selected_weights, so a disabled soft
+// constraint never counts)
+ScheduleScore score_schedule(const InputModel& model, const ScheduleResult& result, const ObjectiveWeights& weights);
+
+// Score with the input's own weights (Rules::objective)
+inline ScheduleScore score_schedule(const InputModel& model, const ScheduleResult& result) {
+    return score_schedule(model, result, model.rules.objective);
+}
@@ -0,0 +1,231 @@
+#include "simulation.hpp"
+#include "constraints.hpp"
+#include "eligibility.hpp"
+#include "rng.hpp"
+#include "timeline.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Shift as the simulation sees it (minutes since the first shift start)
+struct SimShift {
+    std::int32_t start;
+    std::int32_t end;
+    std::int32_t day;      // the eligibility kernel's day
+    std::uint32_t role;    // interned; EligibilityKernel::kNoRole if no staff has it
+    int required;
+};
+
+struct Outcome {
+    long vacated = 0;
+    long repaired = 0;
+    long uncovered_slots = 0;
+    long uncovered_shifts = 0;
+};
+
+// Reused by one thread for all of its samples
+struct ThreadState {
+    WorkerTimelines timelines;
+    std::vector<std::int32_t> minutes;
+    std::vector<std::uint64_t> worked_days; // staff-major bitsets of days with a shift
+    std::vector<int> filled;
+    std::vector<std::uint32_t> vacancies; // shift positions, one per lost assignment
+};
+
+Distribution summarize(std::vector<double> v) {
+    Distribution d;
+    if (v.empty()) return d;
+    std::sort(v.begin(), v.end());
+    auto at = [&](double q) { // nearest rank
+        size_t rank = static_cast<size_t>(q * static_cast<double>(v.size()) + 0.999999);
+        return v[std::min(v.size() - 1, rank > 0 ? rank - 1 : 0)];
+    };
+    double sum = 0;
+    for (double x : v) sum += x;
+    d.mean = sum / static_cast<double>(v.size());
+    d.min = v.front();
+    d.p5 = at(0.05);
+    d.p50 = at(0.50);
+    d.p95 = at(0.95);
+    d.p99 = at(0.99);
+    d.max = v.back();
+    return d;
+}
+
+} // namespace
+
+SimulationReport simulate_callouts(const InputModel& model, const ScheduleResult& schedule,
+                                   const SimulationOptions& opt) {
+    SimulationReport report;
+    report.samples = opt.samples;
+    const size_t n_shifts = schedule.shift_count();
+    const size_t n_staff = model.staff.size();
+    if (n_shifts == 0 || opt.samples == 0) return report;
+
+    // Read-only inputs shared by every thread; the checks are the engine's
+    const EligibilityKernel kernel(model, schedule.shift_index, select_constraints(model.rules).hard);
+    const bool need_rest = (kernel.hard() & constraint::rest) != 0;
+    const bool need_days = (kernel.hard() & constraint::consecutive_days) != 0;
+
+    std::vector<std::vector<std::uint32_t>> by_role(kernel.role_count());
+    for (std::uint32_t w = 0; w < n_staff; ++w) by_role[kernel.staff_role(w)].push_back(w);
+
+    std::vector<std::uint32_t> id_rank(n_staff);
+    {
+        std::vector<std::uint32_t> order(n_staff);
+        for (std::uint32_t w = 0; w < n_staff; ++w) order[w] = w;
+        std::sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+            return model.staff[a].id != model.staff[b].id ? model.staff[a].id < model.staff[b].id : a < b;
+        });
+        for (std::uint32_t r = 0; r < n_staff; ++r) id_rank[order[r]] = r;
+    }
+
+    std::vector<SimShift> shifts(n_shifts);
+    {
+        const SysTime horizon = model.shifts[schedule.shift_index[0]].start;
+        auto minutes_since = [&](const SysTime& t) {
+            return static_cast<std::int32_t>(std::chrono::duration_cast<std::chrono::minutes>(t - horizon).count());
+        };
+        for (size_t k = 0; k < n_shifts; ++k) {
+            const Shifts& sh = model.shifts[schedule.shift_index[k]];
+            shifts[k] = SimShift{minutes_since(sh.start), minutes_since(sh.end), kernel.shift_day(k), kernel.shift_role(k),
+                                 sh.required_count};
+        }
+    }
+
+    // The published schedule as per-worker timelines, totals and worked days
+    const size_t day_words = need_days ? kernel.day_words() : 0;
+    std::vector<std::uint64_t> base_days(n_staff * day_words, 0);
+    WorkerTimelines base_timelines;
+    base_timelines.reset(n_staff, schedule.staff_index.size());
+    std::vector<std::int32_t> base_minutes(n_staff, 0);
+    std::vector<int> base_filled(n_shifts, 0);
+    for (size_t k = 0; k < n_shifts; ++k) {
+        base_filled[k] = static_cast<int>(schedule.staff_count(k));
+        const long required = std::max(shifts[k].required, 0);
+        report.required_slots += required;
+        report.baseline_uncovered_slots += std::max(0L, required - base_filled[k]);
+        for (const std::uint32_t* p = schedule.staff_begin(k); p != schedule.staff_end(k); ++p) {
+            base_timelines.insert(*p, shifts[k].start, shifts[k].end);
+            base_minutes[*p] += shifts[k].end - shifts[k].start;
+            if (need_days) kernel.mark_day(&base_days[*p * day_words], k);
+        }
+    }
+
+    // A draw is a call-out when below rate * 2^64. A double under 1 scales to at most
+    // 2^64 - 2^11, so the cast stays in range; rate 1 (or more) needs no threshold
+    const bool everyone_out = opt.callout_rate >= 1.0;
+    const std::uint64_t threshold =
+        opt.callout_rate > 0.0 && !everyone_out ? static_cast<std::uint64_t>(std::ldexp(opt.callout_rate, 64)) : 0;
+    // Counter-based draws: any (seed, sample, staff, day) maps to the same value, so samples
+    // need no shared RNG state and results don't depend on the thread count
+    auto called_out = [&](std::uint64_t sample_key, std::uint32_t w, std::int32_t day) {
+        std::uint64_t h = splitmix64(sample_key ^ (static_cast<std::uint64_t>(w) << 20) ^ static_cast<std::uint64_t>(day));
+        return everyone_out || splitmix64(h) < threshold;
+    };
+
+    auto run_sample = [&](ThreadState& st, unsigned sample) {
+        const std::uint64_t key = splitmix64(opt.seed ^ splitmix64(sample));
+        st.timelines = base_timelines; // reuses the thread's buffers after the first sample
+        st.minutes = base_minutes;
+        st.filled = base_filled;
+        st.worked_days = base_days;
+        st.vacancies.clear();
+
+        Outcome out;
+        // Call-outs: drop every assignment of an absent worker that day
+        for (size_t k = 0; k < n_shifts; ++k) {
+            for (const std::uint32_t* p = schedule.staff_begin(k); p != schedule.staff_end(k); ++p) {
+                if (!called_out(key, *p, shifts[k].day)) continue;
+                st.timelines.erase(*p, shifts[k].start);
+                st.minutes[*p] -= shifts[k].end - shifts[k].start;
+                --st.filled[k];
+                // Out for the whole day, so no shift of that day is left
+                if (need_days) kernel.clear_day(&st.worked_days[*p * day_words], k);
+                st.vacancies.push_back(static_cast<std::uint32_t>(k));
+                ++out.vacated;
+            }
+        }
+
+        // Repair in shift order: fewest minutes first, then id (like the engine's fairness)
+        for (std::uint32_t k : st.vacancies) {
+            const SimShift& sh = shifts[k];
+            if (sh.role == EligibilityKernel::kNoRole) continue;
+            const std::int32_t dur = sh.end - sh.start;
+            std::uint32_t best = UINT32_MAX;
+            for (std::uint32_t w : by_role[sh.role]) {
+                if (!kernel.available(w, sh.day)) continue;
+                if (!kernel.hours_ok(w, st.minutes[w], k)) continue;
+                if (!st.timelines.fits(w, sh.start, sh.end, need_rest ? std::int32_t{model.staff[w].min_rest} * 60 : 0)) continue;
+                if (need_days && !kernel.consecutive_ok(&st.worked_days[w * day_words], w, k)) continue;
+                if (!kernel.skills_ok(w, k)) continue;
+                if (called_out(key, w, sh.day)) continue;
+                if (best == UINT32_MAX || st.minutes[w] < st.minutes[best] ||
+                    (st.minutes[w] == st.minutes[best] && id_rank[w] < id_rank[best])) {
+                    best = w;
+                }
+            }
+            if (best == UINT32_MAX) continue;
+            st.timelines.insert(best, sh.start, sh.end);
+            st.minutes[best] += dur;
+            if (need_days) kernel.mark_day(&st.worked_days[best * day_words], k);
+            ++st.filled[k];
+            ++out.repaired;
+        }
+
+        for (size_t k = 0; k < n_shifts; ++k) {
+            const int short_by = std::max(shifts[k].required, 0) - st.filled[k];
+            if (short_by > 0) {
+                out.uncovered_slots += short_by;
+                ++out.uncovered_shifts;
+            }
+        }
+        return out;
+    };
+
+    // Samples are claimed in chunks; each thread keeps its own scratch state
+    std::vector<Outcome> outcomes(opt.samples);
+    std::atomic<unsigned> next{0};
+    const unsigned chunk = 16;
+    auto worker = [&] {
+        ThreadState st;
+        for (unsigned begin = next.fetch_add(chunk); begin < opt.samples; begin = next.fetch_add(chunk)) {
+            const unsigned end = std::min(opt.samples, begin + chunk);
+            for (unsigned s = begin; s < end; ++s) outcomes[s] = run_sample(st, s);
+        }
+    };
+
+    unsigned threads = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, (opt.samples + chunk - 1) / chunk);
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& th : pool) th.join();
+
+    std::vector<double> vacated, repaired, uncovered, uncovered_shifts, coverage;
+    for (auto* v : {&vacated, &repaired, &uncovered, &uncovered_shifts, &coverage}) v->reserve(outcomes.size());
+    for (const auto& o : outcomes) {
+        vacated.push_back(static_cast<double>(o.vacated));
+        repaired.push_back(static_cast<double>(o.repaired));
+        uncovered.push_back(static_cast<double>(o.uncovered_slots));
+        uncovered_shifts.push_back(static_cast<double>(o.uncovered_shifts));
+        coverage.push_back(report.required_slots
+                               ? 100.0 * static_cast<double>(report.required_slots - o.uncovered_slots) /
+                                     static_cast<double>(report.required_slots)
+                               : 100.0);
+    }
+    report.vacated_slots = summarize(std::move(vacated));
+    report.repaired_slots = summarize(std::move(repaired));
+    report.uncovered_slots = summarize(std::move(uncovered));
+    report.uncovered_shifts = summarize(std::move(uncovered_shifts));
+    report.coverage_pct = summarize(std::move(coverage));
+    return report;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "model.hpp"
+#include "engine.hpp"
+#include <cstdint>
+
+// Monte Carlo robustness of a published schedule: random call-outs, greedy repair,
+// distribution of what stays uncovered.
+
+struct SimulationOptions {
+    unsigned samples = 1000;
+    double callout_rate = 0.05; // chance that a staff member is out on a given day
+    std::uint64_t seed = 1;     // same seed and samples give the same report on any thread count
+    unsigned threads = 0;       // 0: one per core
+};
+
+// Summary of one metric over all samples
+struct Distribution {
+    double mean = 0;
+    double min = 0;
+    double p5 = 0;
+    double p50 = 0;
+    double p95 = 0;
+    double p99 = 0;
+    double max = 0;
+};
+
+struct SimulationReport {
+    unsigned samples = 0;
+    long required_slots = 0;
+    long baseline_uncovered_slots = 0; // already short in the published schedule
+    Distribution vacated_slots;        // assignments lost to call-outs
+    Distribution repaired_slots;       // refilled by the repair
+    Distribution uncovered_slots;      // short after repair (baseline shortfalls included)
+    Distribution uncovered_shifts;
+    Distribution coverage_pct;
+};
+
+// Sample call-outs against `schedule` (built from `model`) and repair each sample.
+// Repairs keep role, availability and whichever of the hour cap, rest (both sides of the
+// new shift), consecutive days and skills the rules select; a called-out worker is out
+// for every shift starting that day.
+SimulationReport simulate_callouts(const InputModel& model, const ScheduleResult& schedule,
+                                   const SimulationOptions& opt = SimulationOptions{});
@@ -0,0 +1,93 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Every worker's shifts as sorted [start, end) intervals in minutes, kept in one shared
+// buffer. Answers "does this shift fit with enough rest on both sides" with one binary
+// search, so assignments can be added or removed in any order.
+//
+// Each worker owns a contiguous range of the buffer. A full range moves to the end of the
+// buffer with twice the room, so appends (chronological staffing) are amortized O(1) and
+// inserts or removals elsewhere shift only that worker's intervals. All ranges together
+// never take more than 4x the intervals inserted, so reset() can size the buffer once.
+class WorkerTimelines {
+public:
+    struct Interval {
+        std::int32_t start;
+        std::int32_t end;
+    };
+
+    // Empty timelines for `workers` workers, with room for `expected_inserts` inserts in total
+    // (more still works, it only lets the buffer grow)
+    void reset(size_t workers, size_t expected_inserts) {
+        ranges_.assign(workers, Range{});
+        pool_.clear();
+        pool_.reserve(4 * expected_inserts);
+    }
+
+    size_t workers() const { return ranges_.size(); }
+    size_t size(size_t w) const { return ranges_[w].size; }
+    const Interval* begin(size_t w) const { return pool_.data() + ranges_[w].offset; }
+    const Interval* end(size_t w) const { return begin(w) + ranges_[w].size; }
+
+    // True if [start, end) keeps at least `rest` minutes from worker w's neighbouring intervals
+    bool fits(size_t w, std::int32_t start, std::int32_t end, std::int32_t rest) const {
+        const Interval* first = begin(w);
+        const Interval* last = this->end(w);
+        const Interval* next = upper_bound_start(first, last, start);
+        if (next != last && next->start - end < rest) return false;             // next one
+        if (next != first && start - (next - 1)->end < rest) return false;      // previous one
+        return true;
+    }
+
+    void insert(size_t w, std::int32_t start, std::int32_t end) {
+        Range& r = ranges_[w];
+        if (r.size == r.room) grow(r);
+        Interval* first = pool_.data() + r.offset;
+        Interval* last = first + r.size;
+        Interval* at = const_cast<Interval*>(upper_bound_start(first, last, start));
+        std::move_backward(at, last, last + 1);
+        *at = Interval{start, end};
+        ++r.size;
+    }
+
+    // Remove worker w's interval starting at `start` (false if there is none)
+    bool erase(size_t w, std::int32_t start) {
+        Range& r = ranges_[w];
+        Interval* first = pool_.data() + r.offset;
+        Interval* last = first + r.size;
+        Interval* it = std::lower_bound(first, last, start,
+                                        [](const Interval& iv, std::int32_t s) { return iv.start < s; });
+        if (it == last || it->start != start) return false;
+        std::move(it + 1, last, it);
+        --r.size;
+        return true;
+    }
+
+private:
+    static constexpr std::uint32_t kMinRoom = 4;
+
+    struct Range {
+        std::uint32_t offset = 0;
+        std::uint32_t size = 0;
+        std::uint32_t room = 0;
+    };
+
+    static const Interval* upper_bound_start(const Interval* first, const Interval* last, std::int32_t start) {
+        return std::upper_bound(first, last, start, [](std::int32_t s, const Interval& iv) { return s < iv.start; });
+    }
+
+    // Move a full range to the end of the buffer with twice the room (kMinRoom at first)
+    void grow(Range& r) {
+        const std::uint32_t room = std::max(kMinRoom, 2 * r.room);
+        const auto offset = static_cast<std::uint32_t>(pool_.size());
+        pool_.resize(pool_.size() + room);
+        std::copy_n(pool_.begin() + r.offset, r.size, pool_.begin() + offset);
+        r.offset = offset;
+        r.room = room;
+    }
+
+    std::vector<Range> ranges_;
+    std::vector<Interval> pool_;
+};
@@ -0,0 +1,266 @@
+#include "validate.hpp"
+#include "constraints.hpp"
+#include "civil_time.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+const char* violation_name(ViolationKind kind) {
+    switch (kind) {
+        case ViolationKind::UnknownShift:    return "unknown_shift";
+        case ViolationKind::DuplicateShift:  return "duplicate_shift";
+        case ViolationKind::UnknownStaff:    return "unknown_staff";
+        case ViolationKind::DuplicateStaff:  return "duplicate_staff";
+        case ViolationKind::Role:            return "role";
+        case ViolationKind::Availability:    return "availability";
+        case ViolationKind::WeeklyHours:     return "weekly_hours";
+        case ViolationKind::Rest:            return "rest";
+        case ViolationKind::ConsecutiveDays: return "consecutive_days";
+        case ViolationKind::Skills:          return "skills";
+    }
+    return "unknown";
+}
+
+// Split one CSV line on commas (the scheduler writes no quoted fields)
+static void split_fields(std::string_view line, std::vector<std::string_view>& out) {
+    out.clear();
+    for (;;) {
+        const size_t comma = line.find(',');
+        out.push_back(line.substr(0, comma));
+        if (comma == std::string_view::npos) return;
+        line.remove_prefix(comma + 1);
+    }
+}
+
+static std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+    return s;
+}
+
+ScheduleResult read_schedule_csv(const InputModel& model, std::istream& in, std::vector<Violation>& problems) {
+    ScheduleResult result;
+    std::vector<std::uint32_t> order_scratch;
+    result.shift_index = shift_order_of(model, order_scratch);
+
+    std::unordered_map<std::string_view, std::uint32_t> entry_of, staff_of;
+    entry_of.reserve(result.shift_index.size());
+    for (std::uint32_t k = 0; k < result.shift_index.size(); ++k) entry_of.emplace(model.shifts[result.shift_index[k]].id, k);
+    staff_of.reserve(model.staff.size());
+    for (std::uint32_t w = 0; w < model.staff.size(); ++w) staff_of.try_emplace(model.staff[w].id, w);
+
+    // Staff per entry, as read (entries without a row stay empty)
+    std::vector<std::vector<std::uint32_t>> staff(result.shift_index.size());
+    std::vector<std::uint8_t> seen(result.shift_index.size(), 0);
+
+    std::string line;
+    std::vector<std::string_view> fields;
+    constexpr size_t kMissing = SIZE_MAX;
+    size_t shift_col = kMissing, staff_col = kMissing;
+    if (std::getline(in, line)) {
+        split_fields(line, fields);
+        for (size_t c = 0; c < fields.size(); ++c) {
+            if (trim(fields[c]) == "shift_id") shift_col = c;
+            else if (trim(fields[c]) == "assigned_staff_ids") staff_col = c;
+        }
+    }
+    if (shift_col == kMissing) throw std::runtime_error("no shift_id column in the header");
+    if (staff_col == kMissing) throw std::runtime_error("no assigned_staff_ids column in the header");
+    while (std::getline(in, line)) {
+        if (trim(line).empty()) continue;
+        split_fields(line, fields);
+        const std::string_view shift_id = shift_col < fields.size() ? trim(fields[shift_col]) : std::string_view{};
+        auto it = entry_of.find(shift_id);
+        if (it == entry_of.end()) {
+            problems.push_back(Violation{ViolationKind::UnknownShift, "", std::string(shift_id), "not in the input"});
+            continue;
+        }
+        const std::uint32_t k = it->second;
+        if (seen[k]) {
+            problems.push_back(Violation{ViolationKind::DuplicateShift, "", std::string(shift_id), "listed again (row ignored)"});
+            continue;
+        }
+        seen[k] = 1;
+
+        std::string_view ids = staff_col < fields.size() ? fields[staff_col] : std::string_view{};
+        while (!ids.empty()) {
+            const size_t semi = ids.find(';');
+            const std::string_view id = trim(ids.substr(0, semi));
+            ids.remove_prefix(semi == std::string_view::npos ? ids.size() : semi + 1);
+            if (id.empty()) continue;
+            auto w = staff_of.find(id);
+            if (w == staff_of.end()) {
+                problems.push_back(Violation{ViolationKind::UnknownStaff, std::string(id), std::string(shift_id), "not in the input"});
+            } else if (std::find(staff[k].begin(), staff[k].end(), w->second) != staff[k].end()) {
+                problems.push_back(Violation{ViolationKind::DuplicateStaff, std::string(id), std::string(shift_id), "listed twice"});
+            } else {
+                staff[k].push_back(w->second);
+            }
+        }
+    }
+
+    // Flat entries and the totals they imply
+    const PenaltyTable penalties = build_penalty_table(model);
+    result.staff_offsets.reserve(result.shift_index.size() + 1);
+    result.staff_offsets.push_back(0);
+    result.staff_totals.assign(model.staff.size(), StaffTotals{});
+    for (size_t k = 0; k < staff.size(); ++k) {
+        const Shifts& sh = model.shifts[result.shift_index[k]];
+        const auto minutes = static_cast<std::int32_t>(std::chrono::duration_cast<std::chrono::minutes>(sh.end - sh.start).count());
+        const bool night = !staff[k].empty() && sh.is_night();
+        const std::uint32_t unit = penalties.column_of(sh.name);
+        for (std::uint32_t w : staff[k]) {
+            StaffTotals& t = result.staff_totals[w];
+            t.minutes += minutes;
+            t.shifts += 1;
+            t.nights += night;
+            t.preference_violations += penalties.penalty(w, unit, night) > 0;
+        }
+        result.staff_index.insert(result.staff_index.end(), staff[k].begin(), staff[k].end());
+        result.staff_offsets.push_back(static_cast<std::uint32_t>(result.staff_index.size()));
+    }
+    return result;
+}
+
+namespace {
+
+// Entry as the checks see it
+struct CheckShift {
+    std::int64_t start;  // minutes since the first entry's start
+    std::int64_t end;
+    int day;             // days_from_civil of the local start day
+    DateStamp date;
+};
+
+std::string hours_text(std::int64_t minutes) {
+    std::ostringstream oss;
+    oss << minutes / 60;
+    if (minutes % 60) oss << "h" << (minutes % 60 < 10 ? "0" : "") << minutes % 60;
+    else oss << " h";
+    return oss.str();
+}
+
+} // namespace
+
+ValidationReport validate_schedule(const InputModel& model, const ScheduleResult& schedule, unsigned threads) {
+    ValidationReport report;
+    const size_t n_staff = model.staff.size();
+    const size_t n_entries = schedule.shift_count();
+    report.staff_checked = n_staff;
+    report.assignments = schedule.staff_index.size();
+    if (n_entries == 0 || n_staff == 0) return report;
+
+    const ConstraintSet hard = select_constraints(model.rules).hard;
+
+    std::vector<CheckShift> shifts(n_entries);
+    const SysTime horizon = model.shifts[schedule.shift_index[0]].start;
+    for (size_t k = 0; k < n_entries; ++k) {
+        const Shifts& sh = model.shifts[schedule.shift_index[k]];
+        const DateStamp d = sh.day();
+        shifts[k] = CheckShift{std::chrono::duration_cast<std::chrono::minutes>(sh.start - horizon).count(),
+                               std::chrono::duration_cast<std::chrono::minutes>(sh.end - horizon).count(),
+                               days_from_civil(d.y, d.m, d.d), d};
+    }
+
+    // Per-staff lists of entries by counting sort; entries are filled in order, so each
+    // list is sorted by start whenever the schedule's entries are
+    std::vector<std::uint32_t> offsets(n_staff + 1, 0), entries(schedule.staff_index.size());
+    for (std::uint32_t w : schedule.staff_index) ++offsets[w + 1];
+    for (size_t w = 0; w < n_staff; ++w) offsets[w + 1] += offsets[w];
+    {
+        std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (std::uint32_t k = 0; k < n_entries; ++k) {
+            for (const std::uint32_t* p = schedule.staff_begin(k); p != schedule.staff_end(k); ++p) entries[fill[*p]++] = k;
+        }
+    }
+
+    auto check_staff = [&](size_t w, std::vector<Violation>& out) {
+        const Staff& s = model.staff[w];
+        std::uint32_t* first = entries.data() + offsets[w];
+        std::uint32_t* last = entries.data() + offsets[w + 1];
+        std::sort(first, last, [&](std::uint32_t a, std::uint32_t b) {
+            return shifts[a].start != shifts[b].start ? shifts[a].start < shifts[b].start : a < b;
+        });
+        auto report_at = [&](ViolationKind kind, std::uint32_t k, std::string detail) {
+            out.push_back(Violation{kind, s.id, model.shifts[schedule.shift_index[k]].id, std::move(detail)});
+        };
+
+        const std::int64_t cap = std::int64_t{s.max_weekly_hours} * 60;
+        const std::int64_t rest = std::int64_t{s.min_rest} * 60;
+        std::int64_t minutes = 0;
+        bool over_hours = false;
+        std::uint32_t latest = UINT32_MAX; // earlier entry ending last
+        int run = 0, run_day = 0;
+        for (const std::uint32_t* p = first; p != last; ++p) {
+            const std::uint32_t k = *p;
+            const CheckShift& sh = shifts[k];
+            const Shifts& src = model.shifts[schedule.shift_index[k]];
+
+            if (src.req_role != s.role) report_at(ViolationKind::Role, k, "role " + s.role + " but the shift needs " + src.req_role);
+            for (const auto& a : s.availability) {
+                if (a.date.y == sh.date.y && a.date.m == sh.date.m && a.date.d == sh.date.d) {
+                    if (!a.can_work) report_at(ViolationKind::Availability, k, "marked unavailable that day");
+                    break;
+                }
+            }
+            if (hard & constraint::skills) {
+                for (const auto& sk : src.req_skills) {
+                    if (!s.skills.count(sk)) report_at(ViolationKind::Skills, k, "lacks skill " + sk);
+                }
+            }
+            if ((hard & constraint::rest) && latest != UINT32_MAX && sh.start - shifts[latest].end < rest) {
+                const std::int64_t gap = sh.start - shifts[latest].end;
+                report_at(ViolationKind::Rest, k,
+                          (gap < 0 ? "overlaps shift " : hours_text(gap) + " after shift ") +
+                              model.shifts[schedule.shift_index[latest]].id + " (" + hours_text(rest) + " rest required)");
+            }
+            if (latest == UINT32_MAX || sh.end > shifts[latest].end) latest = k;
+
+            minutes += sh.end - sh.start;
+            if ((hard & constraint::weekly_hours) && !over_hours && minutes > cap) {
+                over_hours = true;
+                report_at(ViolationKind::WeeklyHours, k, "reaches " + hours_text(minutes) + " of " + hours_text(cap) + " allowed");
+            }
+            if ((hard & constraint::consecutive_days) && (run == 0 || sh.day > run_day)) {
+                run = run > 0 && sh.day == run_day + 1 ? run + 1 : 1;
+                run_day = sh.day;
+                if (run == s.max_consecutive_days + 1) {
+                    report_at(ViolationKind::ConsecutiveDays, k,
+                              std::to_string(run) + " days in a row (" + std::to_string(s.max_consecutive_days) + " allowed)");
+                }
+            }
+        }
+    };
+
+    // Staff are claimed in chunks; each keeps its own violations, joined in staff order
+    std::vector<std::vector<Violation>> found(n_staff);
+    std::atomic<size_t> next{0};
+    const size_t chunk = 64;
+    auto worker = [&] {
+        for (size_t begin = next.fetch_add(chunk); begin < n_staff; begin = next.fetch_add(chunk)) {
+            const size_t end = std::min(n_staff, begin + chunk);
+            for (size_t w = begin; w < end; ++w) check_staff(w, found[w]);
+        }
+    };
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, (n_staff + chunk - 1) / chunk));
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker(); // this thread works too
+    for (auto& th : pool) th.join();
+
+    size_t total = 0;
+    for (const auto& v : found) total += v.size();
+    report.violations.reserve(total);
+    for (auto& v : found) std::move(v.begin(), v.end(), std::back_inserter(report.violations));
+    return report;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "model.hpp"
+#include "engine.hpp"
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+// Audit of a finished schedule, typically one edited by hand and read back from the CSV the
+// scheduler wrote, against the hard constraints the rules select: the same checks, with the
+// same meaning, the engine applies while staffing (max_weekly_hours caps the total over the
+// schedule, rest applies between any two shifts of a worker, including overlapping ones).
+
+enum class ViolationKind : std::uint8_t {
+    UnknownShift,    // CSV row for a shift id the input does not have
+    DuplicateShift,  // second CSV row for the same shift (ignored)
+    UnknownStaff,    // staff id the input does not have
+    DuplicateStaff,  // staff listed twice on one shift
+    Role,
+    Availability,
+    WeeklyHours,
+    Rest,
+    ConsecutiveDays,
+    Skills,
+};
+
+const char* violation_name(ViolationKind kind);
+
+struct Violation {
+    ViolationKind kind;
+    std::string staff_id;  // empty for shift-level problems
+    std::string shift_id;
+    std::string detail;    // no commas (written as a CSV field)
+};
+
+// A schedule CSV (columns found by header name: shift_id and assigned_staff_ids, ids
+// separated by ';') as a ScheduleResult over the input's unique shifts in start order.
+// Staff totals are recounted; rows and ids that do not match the input go to `problems`.
+// Throws std::runtime_error if the header lacks either column.
+ScheduleResult read_schedule_csv(const InputModel& model, std::istream& in, std::vector<Violation>& problems);
+
+struct ValidationReport {
+    size_t staff_checked = 0;
+    size_t assignments = 0;
+    std::vector<Violation> violations; // by staff (input order), then shift start
+};
+
+// Check every staff member's shifts (threads = 0: one per core). The result does not
+// depend on the thread count.
+ValidationReport validate_schedule(const InputModel& model, const ScheduleResult& schedule, unsigned threads = 0);
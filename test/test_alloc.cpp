@@ -0,0 +1,74 @@
+#include "../src/model.hpp"
+#include "../src/engine.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+// Count every heap allocation made through the global allocation functions
+
+static std::atomic<size_t> g_allocs{0};
+
+void* operator new(size_t n) {
+    g_allocs.fetch_add(1);
+    void* p = std::malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](size_t n) { return operator new(n); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+// Back-to-back one-hour shifts, one nurse each, no shortfall (so no warnings)
+static InputModel make_model(int n_shifts) {
+    InputModel m;
+    for (int i = 0; i < 8; ++i) {
+        Staff s;
+        s.id = "N" + std::to_string(i); // short ids stay in the small-string buffer
+        s.role = "RN";
+        s.max_weekly_hours = 10000;
+        s.min_rest = 0;
+        m.staff.push_back(s);
+    }
+    SysTime base = to_time_point(DateTimeStamp{2025, 4, 7, 0, 0});
+    for (int i = 0; i < n_shifts; ++i) {
+        Shifts sh;
+        sh.id = "S" + std::to_string(i);
+        sh.name = "ICU";
+        sh.req_role = "RN";
+        sh.required_count = 1;
+        sh.start = base + Hours(i);
+        sh.end = base + Hours(i + 1);
+        m.shifts.push_back(sh);
+    }
+    index_shifts(m);
+    return m;
+}
+
+static size_t allocs_for(const InputModel& m) {
+    size_t before = g_allocs.load();
+    auto res = build_schedule(m);
+    size_t used = g_allocs.load() - before;
+    assert(res.shift_count() == m.shifts.size());
+    assert(res.warnings.empty());
+    return used;
+}
+
+int main() {
+    // ---- Test 1: the per-shift loop does not allocate ----
+    {
+        const int n = 200;
+        InputModel small = make_model(n);
+        InputModel large = make_model(2 * n);
+        size_t a = allocs_for(small);
+        size_t b = allocs_for(large);
+        // Result and scratch are sized once up front: no allocation per shift
+        assert(b == a);
+    }
+
+    std::cout << "alloc_tests: all tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,191 @@
+#include "../src/model.hpp"
+#include "../src/engine.hpp"
+#include "../src/anneal.hpp"
+#include "../src/score.hpp"
+#include "../src/civil_time.hpp"
+#include "test_util.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <set>
+
+static long minutes_of(const Shifts& sh) {
+    return std::chrono::duration_cast<std::chrono::minutes>(sh.end - sh.start).count();
+}
+
+// Every default hard constraint plus consecutive days and skills, checked on the finished schedule, and the
+// totals recounted from the staff lists
+static bool valid(const InputModel& m, const ScheduleResult& r) {
+    std::vector<std::vector<const Shifts*>> worked(m.staff.size());
+    for (size_t k = 0; k < r.shift_count(); ++k) {
+        const Shifts& sh = m.shifts[r.shift_index[k]];
+        std::set<std::uint32_t> seen(r.staff_begin(k), r.staff_end(k));
+        if (seen.size() != r.staff_count(k) || static_cast<long>(r.staff_count(k)) > std::max<long>(sh.required_count, 0)) return false;
+        for (const std::uint32_t* p = r.staff_begin(k); p != r.staff_end(k); ++p) worked[*p].push_back(&sh);
+    }
+    for (size_t w = 0; w < m.staff.size(); ++w) {
+        const Staff& s = m.staff[w];
+        auto& list = worked[w];
+        std::sort(list.begin(), list.end(), [](const Shifts* a, const Shifts* b) { return a->start < b->start; });
+        long minutes = 0;
+        std::set<int> days;
+        for (size_t i = 0; i < list.size(); ++i) {
+            const Shifts& sh = *list[i];
+            if (sh.req_role != s.role) return false;
+            const DateStamp d = sh.day();
+            for (const auto& a : s.availability) {
+                if (a.date.y == d.y && a.date.m == d.m && a.date.d == d.d && !a.can_work) return false;
+            }
+            for (const auto& sk : sh.req_skills) {
+                if (!s.skills.count(sk)) return false;
+            }
+            if (i > 0 && sh.start - list[i - 1]->end < Hours(s.min_rest)) return false;
+            minutes += minutes_of(sh);
+            days.insert(days_from_civil(d.y, d.m, d.d));
+        }
+        if (minutes > s.max_weekly_hours * 60L || r.staff_totals[w].minutes != minutes) return false;
+        int run = 0, prev = 0;
+        for (int d : days) {
+            run = (run > 0 && d == prev + 1) ? run + 1 : 1;
+            prev = d;
+            if (run > s.max_consecutive_days) return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    // ---- Test 1: random rosters: never a worse score, hard rules kept, same seed same result ----
+    {
+        for (unsigned seed = 1; seed <= 20; ++seed) {
+            unsigned state = seed;
+            auto next = [&](unsigned mod) { state = state * 1103515245u + 12345u; return (state >> 16) % mod; };
+            const char* roles[] = {"RN", "LPN"};
+            InputModel m;
+            for (int i = 0; i < 12; ++i) {
+                Staff s;
+                s.id = "s" + std::to_string(i);
+                s.role = roles[next(2)];
+                s.max_weekly_hours = static_cast<short>(8 + next(40));
+                s.min_rest = static_cast<short>(next(13));
+                s.max_consecutive_days = static_cast<short>(1 + next(4));
+                if (next(3) == 0) s.skills = {"vent"};
+                if (next(2) == 0) s.prefs.avoid_nights = true;
+                for (int d = 1; d <= 7; ++d) {
+                    if (next(5) == 0) s.availability.push_back({DateStamp{2025, 4, d}, false});
+                }
+                m.staff.push_back(s);
+            }
+            for (int i = 0; i < 40; ++i) {
+                Shifts sh = make_shift("x" + std::to_string(i), roles[next(2)], 1 + static_cast<int>(next(7)),
+                                       static_cast<int>(next(24)), 4 + static_cast<int>(next(9)), static_cast<int>(next(4)));
+                if (next(4) == 0) sh.req_skills = {"vent"};
+                m.shifts.push_back(sh);
+            }
+            index_shifts(m);
+            m.rules.hard_constraints = {"coverage", "legal_limits", "consecutive_days", "skills"};
+            m.rules.objective.night_variance = seed % 2 ? 5.0 : 0.0;
+
+            const ScheduleResult greedy = build_schedule(m);
+            EngineOptions opt;
+            opt.anneal.max_moves = 20000;
+            opt.anneal.seed = seed;
+            const ScheduleResult r = build_schedule(m, opt);
+            assert(valid(m, r));
+            assert(r.anneal.moves == opt.anneal.max_moves);
+            const ScheduleScore before = score_schedule(m, greedy);
+            const ScheduleScore after = score_schedule(m, r);
+            assert(after.total <= before.total + 1e-9);
+            assert(std::abs(after.total - r.anneal.final_score) < 1e-6);
+            assert(std::abs(before.total - r.anneal.initial_score) < 1e-6);
+
+            // One shortfall warning per shift left short, whatever the greedy pass left
+            size_t short_shifts = 0;
+            for (size_t k = 0; k < r.shift_count(); ++k) {
+                const Shifts& sh = m.shifts[r.shift_index[k]];
+                if (sh.required_count <= static_cast<long>(r.staff_count(k))) continue;
+                ++short_shifts;
+                const std::string tail = "for shift " + sh.id;
+                assert(std::count_if(r.warnings.begin(), r.warnings.end(), [&](const std::string& w) {
+                    return w.find(tail + " (") != std::string::npos ||
+                           (w.size() >= tail.size() && w.compare(w.size() - tail.size(), tail.size(), tail) == 0);
+                }) == 1);
+            }
+            assert(static_cast<long>(short_shifts) <= after.shortfall_slots);
+
+            const ScheduleResult again = build_schedule(m, opt);
+            assert(again.staff_index == r.staff_index && again.staff_offsets == r.staff_offsets);
+        }
+    }
+
+    // ---- Test 2: a slot greedy cannot fill is filled by moving staff around ----
+    {
+        InputModel m;
+        for (const char* id : {"a", "b"}) {
+            Staff s;
+            s.id = id;
+            s.role = "RN";
+            m.staff.push_back(s);
+        }
+        m.staff[0].max_weekly_hours = 16;
+        m.staff[1].max_weekly_hours = 8;
+        m.shifts = {make_shift("day", "RN", 1, 7, 8, 1), make_shift("double", "RN", 3, 7, 16, 1)};
+        index_shifts(m);
+
+        const ScheduleResult greedy = build_schedule(m);
+        assert(greedy.staff_count(1) == 0 && greedy.warnings.size() == 1);
+
+        EngineOptions opt;
+        opt.anneal.max_moves = 2000;
+        const ScheduleResult r = build_schedule(m, opt);
+        assert(r.staff_count(0) == 1 && r.staff_begin(0)[0] == 1);
+        assert(r.staff_count(1) == 1 && r.staff_begin(1)[0] == 0);
+        assert(r.warnings.empty());
+        assert(r.staff_totals[0].minutes == 16 * 60 && r.staff_totals[1].minutes == 8 * 60);
+        assert(r.anneal.final_score < r.anneal.initial_score && r.anneal.accepted > 0);
+
+        // Exact mode's report follows the annealed schedule (here the role is too big to search)
+        opt.exact.enabled = true;
+        opt.exact.max_staff = 1;
+        const ScheduleResult both = build_schedule(m, opt);
+        assert(both.exact.size() == 1 && !both.exact[0].searched);
+        assert(both.exact[0].greedy_shortfall == 1 && both.exact[0].shortfall == 0);
+
+        // No budget: anneal mode is off
+        const ScheduleResult off = build_schedule(m, EngineOptions{});
+        assert(off.anneal.moves == 0 && off.staff_index == greedy.staff_index);
+
+        // Called directly without a budget it returns the input at once
+        const AnnealOutcome none = anneal_assignments(m, greedy, build_penalty_table(m), AnnealOptions{});
+        assert(!none.improved && none.stats.moves == 0);
+        assert(none.staff_offsets == greedy.staff_offsets && none.staff_index == greedy.staff_index);
+    }
+
+    // ---- Test 3: soft constraints the rules turn off are not optimized ----
+    {
+        InputModel m;
+        m.staff = {make_staff("a", "RN"), make_staff("b", "RN")};
+        m.staff[0].prefs.preferred_unit = {"ER"};
+        m.shifts = {make_shift("icu", "RN", 1, 7, 8, 1)};
+        index_shifts(m);
+
+        EngineOptions plain;
+        plain.respect_preferences = false;
+        const ScheduleResult greedy = build_schedule(m, plain);
+        assert(greedy.staff_begin(0)[0] == 0 && greedy.staff_totals[0].preference_violations == 1);
+
+        AnnealOptions opt;
+        opt.max_moves = 500;
+        opt.weights = ObjectiveWeights{0.0, 0.0, 1.0, 0.0};
+        const AnnealOutcome moved = anneal_assignments(m, greedy, build_penalty_table(m), opt);
+        assert(moved.improved && moved.staff_index[0] == 1);
+
+        m.rules.soft_constraints = {"fairness"};
+        const AnnealOutcome kept = anneal_assignments(m, greedy, build_penalty_table(m), opt);
+        assert(!kept.improved && kept.stats.initial_score == 0.0 && kept.stats.final_score == 0.0);
+    }
+
+    std::cout << "anneal_tests: all tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include "../src/model.hpp"
+#include "../src/eligibility.hpp"
+#include "test_util.hpp"
+#include <cassert>
+#include <iostream>
+
+int main() {
+    // ---- Test 1: availability by date, the first entry for a day decides ----
+    {
+        Staff s = make_staff("a", "RN");
+        assert(available_on(s, DateStamp{2025, 4, 1}));
+        s.availability = {{DateStamp{2025, 4, 1}, false}, {DateStamp{2025, 4, 1}, true}, {DateStamp{2025, 4, 2}, true}};
+        assert(!available_on(s, DateStamp{2025, 4, 1}));
+        assert(available_on(s, DateStamp{2025, 4, 2}) && available_on(s, DateStamp{2025, 4, 3}));
+    }
+
+    // ---- Test 2: runs of worked days ----
+    {
+        const bool days[] = {true, true, false, true, false};
+        auto worked = [&](std::int32_t d) { return days[d]; };
+        assert(!consecutive_run_ok(worked, 2, 5, 3));  // joins 0-1 and 3 into four days
+        assert(consecutive_run_ok(worked, 2, 5, 4));
+        assert(consecutive_run_ok(worked, 1, 5, 1));   // already worked: the run does not grow
+        assert(consecutive_run_ok(worked, 4, 5, 2));
+        assert(!consecutive_run_ok(worked, 4, 5, 1));
+    }
+
+    // ---- Test 3: the kernel over a small model ----
+    {
+        InputModel m;
+        m.staff = {make_staff("a", "RN"), make_staff("b", "LPN"), make_staff("c", "RN")};
+        m.staff[0].skills = {"vent"};
+        m.staff[0].max_consecutive_days = 2;
+        m.staff[2].availability = {{DateStamp{2025, 4, 3}, false}};
+        m.staff[2].max_weekly_hours = 10;
+        m.shifts = {make_shift("d2", "RN", 2, 7, 8, 1), make_shift("d3", "RN", 3, 7, 12, 1),
+                    make_shift("d4", "CNA", 4, 7, 8, 1)};
+        m.shifts[1].req_skills = {"vent"};
+        index_shifts(m);
+
+        const std::vector<std::uint32_t> all = {0, 1, 2};
+        const EligibilityKernel k(m, all, constraint::defaults | constraint::consecutive_days | constraint::skills);
+        assert(k.hard() & constraint::skills);
+        assert(k.role_count() == 2 && k.staff_role(0) == k.staff_role(2) && k.staff_role(1) != k.staff_role(0));
+        assert(k.shift_role(0) == k.staff_role(0) && k.shift_role(2) == EligibilityKernel::kNoRole);
+        assert(k.day_count() == 3 && k.shift_day(0) == 0 && k.shift_day(2) == 2 && k.day_words() == 1);
+
+        assert(k.role_ok(0, 0) && !k.role_ok(1, 0) && !k.role_ok(0, 2));
+        assert(k.available(2, 0) && !k.available(2, 1));
+        assert(k.skills_ok(0, 1) && !k.skills_ok(2, 1) && k.skills_ok(2, 0));
+        assert(k.hours_ok(2, 0, 0) && !k.hours_ok(2, 3 * 60, 0));
+        assert(k.static_ok(0, 1) && !k.static_ok(2, 1) && !k.static_ok(1, 0));
+
+        std::uint64_t days = 0;
+        k.mark_day(&days, 0);
+        k.mark_day(&days, 2);
+        assert(!k.consecutive_ok(&days, 0, 1)); // a three-day run past a's limit of two
+        assert(k.consecutive_ok(&days, 2, 1));  // c's limit is the default
+        k.clear_day(&days, 2);
+        assert(k.consecutive_ok(&days, 0, 1));
+
+        // Checks the rules leave out always pass; skills drop when no shift needs one
+        const EligibilityKernel loose(m, all, constraint::always);
+        assert(loose.hours_ok(2, 100 * 60, 0) && loose.skills_ok(2, 1));
+        assert(!loose.static_ok(2, 1)); // availability is always on
+        const std::vector<std::uint32_t> plain = {0, 2};
+        const EligibilityKernel unskilled(m, plain, constraint::always | constraint::skills);
+        assert(!(unskilled.hard() & constraint::skills) && unskilled.day_count() == 3);
+    }
+
+    std::cout << "eligibility_tests: all tests passed.\n";
+    return 0;
+}
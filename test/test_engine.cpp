@@ -1,5 +1,7 @@
 #include "../src/model.hpp"
 #include "../src/engine.hpp"
+#include "../src/constraints.hpp"
+#include "../src/profiler.hpp"
 #include <cassert>
 #include <iostream>
 
@@ -9,6 +11,42 @@ static SysTime make_time(int year, int month, int day, int hour, int minute) {
     return to_time_point(dt);
 }
 
+// Randomized roster: mixed roles, caps, rest, availability gaps, preferences and duplicate ids
+static InputModel make_random_model(unsigned seed) {
+    InputModel m;
+    auto next = [&](unsigned mod) { seed = seed * 1103515245u + 12345u; return (seed >> 16) % mod; };
+    const char* roles[] = {"RN", "LPN", "CNA"};
+    const char* units[] = {"ICU", "ER", "Ward"};
+
+    for (int i = 0; i < 60; ++i) {
+        Staff s;
+        s.id = "s" + std::to_string(next(1000)); // duplicate ids on purpose
+        s.role = roles[next(3)];
+        s.max_weekly_hours = static_cast<short>(16 + next(40));
+        s.min_rest = static_cast<short>(next(13));
+        s.prefs.avoid_nights = next(3) == 0;
+        if (next(2)) s.prefs.preferred_unit = {units[next(3)]};
+        for (int d = 1; d <= 14; ++d) {
+            if (next(6) == 0) s.availability.push_back(Availability{DateStamp{2025, 4, d}, false});
+        }
+        m.staff.push_back(s);
+    }
+    for (int i = 0; i < 300; ++i) {
+        Shifts sh;
+        sh.id = "sh" + std::to_string(i);
+        sh.name = units[next(3)];
+        sh.req_role = i % 50 == 0 ? "MD" : roles[next(3)];
+        sh.required_count = static_cast<short>(next(4));
+        int day = 1 + static_cast<int>(next(14));
+        int hour = static_cast<int>(next(24));
+        sh.start = make_time(2025, 4, day, hour, 0);
+        sh.end   = make_time(2025, 4, day, hour + 4 + static_cast<int>(next(9)), 0);
+        m.shifts.push_back(sh);
+    }
+    index_shifts(m);
+    return m;
+}
+
 int main() {
     // ---- Test 1: prefers non-night-avoiding nurse on night shift ----
     {
@@ -50,8 +88,9 @@ int main() {
         opt.respect_preferences = true;
 
         auto res = build_schedule(m, opt);
-        assert(res.assignments.size() == 1);
-        const auto& asg = res.assignments[0];
+        auto asgs = to_assignments(m, res);
+        assert(asgs.size() == 1);
+        const auto& asg = asgs[0];
         assert(asg.staff_ids.size() == 1);
         // Should pick the nurse who does NOT avoid nights
         assert(asg.staff_ids[0] == "nurse_night_ok");
@@ -88,8 +127,9 @@ int main() {
 
         EngineOptions opt;
         auto res = build_schedule(m, opt);
-        assert(res.assignments.size() == 1);
-        const auto& asg = res.assignments[0];
+        auto asgs = to_assignments(m, res);
+        assert(asgs.size() == 1);
+        const auto& asg = asgs[0];
         // lowCap cannot take 12h with an 8h cap, so highCap must be chosen
         assert(asg.staff_ids.size() == 1);
         assert(asg.staff_ids[0] == "high_cap");
@@ -119,14 +159,559 @@ int main() {
 
         EngineOptions opt;
         auto res = build_schedule(m, opt);
-        assert(res.assignments.size() == 1);
-        const auto& asg = res.assignments[0];
+        auto asgs = to_assignments(m, res);
+        assert(asgs.size() == 1);
+        const auto& asg = asgs[0];
         assert(asg.staff_ids.size() == 1); // only 1 assigned
         assert(asg.staff_ids[0] == "nurse1");
         // Should have a warning about short coverage
         assert(!res.warnings.empty());
     }
 
+#if HOS_DIAGNOSTICS
+    // ---- Test 4: diagnostics count the first failed check per staff ----
+    {
+        InputModel m;
+
+        Staff rn;
+        rn.id = "rn";
+        rn.role = "RN";
+        rn.min_rest = 0;
+
+        Staff lpn;
+        lpn.id = "lpn";
+        lpn.role = "LPN"; // wrong role
+        lpn.min_rest = 0;
+
+        Staff off;
+        off.id = "rn_off";
+        off.role = "RN";
+        off.min_rest = 0;
+        off.availability.push_back({DateStamp{2025, 4, 1}, false}); // day off
+
+        Staff capped;
+        capped.id = "rn_capped";
+        capped.role = "RN";
+        capped.max_weekly_hours = 4; // too few hours
+        capped.min_rest = 0;
+
+        m.staff = {rn, lpn, off, capped};
+
+        Shifts sh;
+        sh.id = "day_shift";
+        sh.name = "ICU";
+        sh.start = make_time(2025, 4, 1, 7, 0);
+        sh.end   = make_time(2025, 4, 1, 15, 0);
+        sh.req_role = "RN";
+        sh.required_count = 1;
+        m.shifts.push_back(sh);
+
+        EngineOptions opt;
+        opt.diagnostics = true;
+        auto res = build_schedule(m, opt);
+        assert(res.diagnostics.size() == 1);
+        const auto& d = res.diagnostics[0];
+        assert(d.shift_id == "day_shift");
+        assert(d.eligible == 1);
+        assert(d.rejected_role == 1);
+        assert(d.rejected_availability == 1);
+        assert(d.rejected_hours == 1);
+        assert(d.rejected_rest == 0);
+
+        // Off by default
+        auto plain = build_schedule(m, EngineOptions{});
+        assert(plain.diagnostics.empty());
+    }
+#endif
+
+#if HOS_PROFILING
+    // ---- Test 5: profiler sees every shift ----
+    {
+        InputModel m;
+
+        Staff a;
+        a.id = "nurse1";
+        a.role = "RN";
+        a.min_rest = 0;
+        m.staff.push_back(a);
+
+        for (int d = 1; d <= 3; ++d) {
+            Shifts sh;
+            sh.id = "s" + std::to_string(d);
+            sh.name = "ICU";
+            sh.start = make_time(2025, 4, d, 7, 0);
+            sh.end   = make_time(2025, 4, d, 15, 0);
+            sh.req_role = "RN";
+            m.shifts.push_back(sh);
+        }
+
+        Profiler prof;
+        EngineOptions opt;
+        opt.profiler = &prof;
+        build_schedule(m, opt);
+
+        std::string js = prof.to_json();
+        assert(js.find("\"candidate_filter\": {\"ms\": ") != std::string::npos);
+        assert(js.find("\"candidates_examined\": {\"total\": 3, \"samples\": 3") != std::string::npos);
+        assert(js.find("\"shift_dedup_sort\"") != std::string::npos);
+    }
+#endif
+
+    // ---- Test 6: minute-exact hours and rest ----
+    {
+        InputModel m;
+
+        Staff a;
+        a.id = "nurse1";
+        a.role = "RN";
+        a.max_weekly_hours = 7; // 7.5h shift must not fit
+        a.min_rest = 0;
+        m.staff.push_back(a);
+
+        Shifts sh;
+        sh.id = "half_past";
+        sh.name = "ICU";
+        sh.start = make_time(2025, 4, 1, 7, 30);
+        sh.end   = make_time(2025, 4, 1, 15, 0); // 7.5h
+        sh.req_role = "RN";
+        m.shifts.push_back(sh);
+
+        auto res = build_schedule(m, EngineOptions{});
+        assert(res.shift_count() == 1);
+        assert(res.staff_count(0) == 0);
+
+        // Overlapping by 30 minutes is not "0 hours of rest"
+        m.staff[0].max_weekly_hours = 40;
+        Shifts overlap = sh;
+        overlap.id = "overlap";
+        overlap.start = make_time(2025, 4, 1, 14, 30);
+        overlap.end   = make_time(2025, 4, 1, 18, 0);
+        m.shifts.push_back(overlap);
+
+        res = build_schedule(m, EngineOptions{});
+        assert(res.shift_count() == 2);
+        assert(res.staff_count(0) == 1);
+        assert(res.staff_count(1) == 0);
+    }
+
+    // ---- Test 7: duplicate ids keep the first occurrence, output follows start order ----
+    {
+        InputModel m;
+
+        Staff a;
+        a.id = "nurse1";
+        a.role = "RN";
+        a.min_rest = 0;
+        m.staff.push_back(a);
+
+        Shifts late;
+        late.id = "late";
+        late.name = "ICU";
+        late.start = make_time(2025, 4, 2, 7, 0);
+        late.end   = make_time(2025, 4, 2, 15, 0);
+        late.req_role = "RN";
+
+        Shifts early = late;
+        early.id = "early";
+        early.start = make_time(2025, 4, 1, 7, 0);
+        early.end   = make_time(2025, 4, 1, 15, 0);
+
+        Shifts dup = late; // same id, different time: ignored
+        dup.start = make_time(2025, 3, 30, 7, 0);
+        dup.end   = make_time(2025, 3, 30, 15, 0);
+
+        m.shifts = {late, early, dup};
+
+        auto order = unique_shift_order(m.shifts);
+        assert(order.size() == 2);
+        assert(order[0] == 1 && order[1] == 0);
+
+        auto res = build_schedule(m, EngineOptions{}); // not indexed: engine computes the order
+        assert(res.shift_count() == 2);
+        assert(res.shift_index[0] == 1 && res.shift_index[1] == 0);
+        auto asgs = to_assignments(m, res);
+        assert(asgs[0].shift_id == "early");
+        assert(asgs[1].shift_id == "late");
+
+        index_shifts(m);
+        auto indexed = build_schedule(m, EngineOptions{});
+        assert(to_assignments(m, indexed)[0].shift_id == "early");
+    }
+
+    // ---- Test 8: flat result layout matches the compatibility view ----
+    {
+        InputModel m;
+        for (const char* id : {"n1", "n2", "n3"}) {
+            Staff s;
+            s.id = id;
+            s.role = "RN";
+            s.min_rest = 0;
+            m.staff.push_back(s);
+        }
+
+        Shifts day;
+        day.id = "day";
+        day.name = "ICU";
+        day.req_role = "RN";
+        day.required_count = 2;
+        day.start = make_time(2025, 4, 1, 7, 0);
+        day.end   = make_time(2025, 4, 1, 15, 0);
+
+        Shifts surgery = day;
+        surgery.id = "surgery";
+        surgery.req_role = "MD"; // nobody eligible
+        surgery.required_count = 1;
+
+        Shifts night = day;
+        night.id = "night";
+        night.required_count = 1;
+        night.start = make_time(2025, 4, 1, 15, 0);
+        night.end   = make_time(2025, 4, 1, 23, 0);
+        m.shifts = {day, surgery, night};
+        index_shifts(m);
+
+        auto res = build_schedule(m, EngineOptions{});
+        assert(res.shift_count() == 3);
+        assert(res.staff_offsets.size() == 4);
+        assert(res.staff_offsets[0] == 0 && res.staff_offsets[3] == res.staff_index.size());
+        assert(res.staff_index.size() == 3);
+
+        auto asgs = to_assignments(m, res);
+        assert(asgs.size() == 3);
+        for (size_t k = 0; k < asgs.size(); ++k) {
+            assert(asgs[k].shift_id == m.shifts[res.shift_index[k]].id);
+            assert(asgs[k].staff_ids.size() == res.staff_count(k));
+            for (size_t j = 0; j < res.staff_count(k); ++j) {
+                assert(asgs[k].staff_ids[j] == m.staff[res.staff_begin(k)[j]].id);
+            }
+        }
+        assert(asgs[0].shift_id == "day" && asgs[0].staff_ids.size() == 2);
+        assert(asgs[1].shift_id == "surgery" && asgs[1].staff_ids.empty());
+        assert(asgs[2].shift_id == "night" && asgs[2].staff_ids[0] == "n3"); // fewest hours
+    }
+
+    // ---- Test 9: per-staff totals and weekly minutes come back with the result ----
+    {
+        InputModel m;
+
+        Staff a;
+        a.id = "nurse1";
+        a.role = "RN";
+        a.min_rest = 0;
+        a.prefs.avoid_nights = true;
+        a.prefs.preferred_unit = {"ER"};
+        m.staff.push_back(a);
+
+        Staff idle = a;
+        idle.id = "nurse2";
+        idle.role = "LPN";
+        m.staff.push_back(idle);
+
+        Shifts mon;
+        mon.id = "mon";
+        mon.name = "ICU"; // not preferred
+        mon.req_role = "RN";
+        mon.start = make_time(2025, 4, 7, 7, 0); // a Monday
+        mon.end   = make_time(2025, 4, 7, 15, 0);
+
+        Shifts sun = mon;
+        sun.id = "sun_night";
+        sun.name = "ER";
+        sun.start = make_time(2025, 4, 13, 22, 0); // night, still week 0
+        sun.end   = make_time(2025, 4, 14, 6, 0);
+
+        Shifts next = mon;
+        next.id = "next_mon";
+        next.name = "ER";
+        next.start = make_time(2025, 4, 14, 7, 0);
+        next.end   = make_time(2025, 4, 14, 8, 30);
+
+        m.shifts = {mon, sun, next};
+        index_shifts(m);
+
+        auto res = build_schedule(m, EngineOptions{});
+        assert(res.staff_totals.size() == 2);
+        const StaffTotals& t = res.staff_totals[0];
+        assert(t.minutes == 8 * 60 + 8 * 60 + 90);
+        assert(t.shifts == 3);
+        assert(t.nights == 1);
+        assert(t.preference_violations == 2);
+        assert(res.staff_totals[1].shifts == 0 && res.staff_totals[1].minutes == 0);
+
+        assert(res.week_start == (DateStamp{2025, 4, 7}));
+        assert(res.week_count == 2);
+        assert(res.week_minutes_of(0, 0) == 16 * 60);
+        assert(res.week_minutes_of(0, 1) == 90);
+        assert(res.week_minutes_of(1, 0) == 0);
+    }
+
+#if HOS_DIAGNOSTICS
+    // ---- Test 10: fairness heap picks exactly what the full scan picks ----
+    {
+        InputModel m = make_random_model(12345);
+
+        EngineOptions heap_opt;                  // fairness on, no diagnostics: heap path
+        EngineOptions scan_opt;
+        scan_opt.diagnostics = true;             // diagnostics force the full scan
+        auto a = build_schedule(m, heap_opt);
+        auto b = build_schedule(m, scan_opt);
+        assert(a.shift_index == b.shift_index);
+        assert(a.staff_offsets == b.staff_offsets);
+        assert(a.staff_index == b.staff_index);
+        assert(a.warnings == b.warnings);
+        assert(!a.staff_index.empty() && !a.warnings.empty());
+    }
+#endif
+
+    // ---- Test 11: penalty table matches the preference rules and can be shared ----
+    {
+        InputModel m;
+
+        Staff plain;
+        plain.id = "plain";
+        plain.role = "RN";
+        m.staff.push_back(plain);
+
+        Staff picky = plain;
+        picky.id = "picky";
+        picky.prefs.avoid_nights = true;
+        picky.prefs.preferred_unit = {"ER", "Nowhere"};
+        m.staff.push_back(picky);
+
+        Shifts icu;
+        icu.id = "icu";
+        icu.name = "ICU";
+        icu.req_role = "RN";
+        icu.start = make_time(2025, 4, 1, 7, 0);
+        icu.end   = make_time(2025, 4, 1, 15, 0);
+        Shifts er = icu;
+        er.id = "er";
+        er.name = "ER";
+        m.shifts = {icu, er};
+        index_shifts(m);
+
+        PenaltyTable t = build_penalty_table(m);
+        assert(t.staff_count == 2 && t.columns == 3);
+        const std::uint32_t c_icu = t.column_of("ICU"), c_er = t.column_of("ER"), c_other = t.column_of("Lab");
+        assert(c_other == 2);
+        assert(t.penalty(0, c_icu, true) == 0 && t.penalty(0, c_other, false) == 0);
+        assert(t.penalty(1, c_er, false) == 0);
+        assert(t.penalty(1, c_icu, false) == 1);
+        assert(t.penalty(1, c_other, false) == 1);
+        assert(t.penalty(1, c_er, true) == 5);
+
+        EngineOptions shared;
+        shared.penalties = &t;
+        auto a = build_schedule(m, EngineOptions{});
+        auto b = build_schedule(m, shared);
+        assert(a.staff_index == b.staff_index);
+        assert(to_assignments(m, b)[1].staff_ids[0] == "picky"); // ER is free of penalty for picky
+        assert(t.built_for(m));
+
+        // Same staff count, other preferences: built_for tells the caller to build another
+        InputModel swapped = m;
+        std::swap(swapped.staff[0].prefs, swapped.staff[1].prefs);
+        assert(!t.built_for(swapped));
+        const PenaltyTable t2 = build_penalty_table(swapped);
+        assert(t2.built_for(swapped));
+        EngineOptions shared2;
+        shared2.penalties = &t2;
+        auto fresh = build_schedule(swapped, EngineOptions{});
+        auto reused = build_schedule(swapped, shared2);
+        assert(reused.staff_index == fresh.staff_index);
+        assert(to_assignments(swapped, reused)[1].staff_ids[0] == "plain");
+
+        // A unit the table has no column for
+        InputModel moved = m;
+        moved.shifts[1].name = "Lab";
+        assert(!t.built_for(moved));
+        moved.staff[1].prefs.preferred_unit = {"Lab"};
+        assert(to_assignments(moved, build_schedule(moved))[1].staff_ids[0] == "picky");
+    }
+
+    // ---- Test 12: every specialized loop matches the runtime-branching loop ----
+    {
+        InputModel m = make_random_model(777);
+        for (bool fair : {true, false}) {
+            for (bool pref : {true, false}) {
+                EngineOptions spec;
+                spec.fairness_on = fair;
+                spec.respect_preferences = pref;
+                EngineOptions runtime = spec;
+                runtime.runtime_dispatch = true;
+                auto a = build_schedule(m, spec);
+                auto b = build_schedule(m, runtime);
+                assert(a.staff_offsets == b.staff_offsets);
+                assert(a.staff_index == b.staff_index);
+                assert(a.warnings == b.warnings);
+            }
+        }
+    }
+
+    // ---- Test 13: constraints are selected by the rules ----
+    {
+        Rules r;
+        ConstraintSelection sel = select_constraints(r);
+        assert(sel.hard == constraint::defaults && sel.fairness && sel.preferences && sel.unknown.empty());
+
+        r.hard_constraints = {"coverage", "legal_limits", "skills", "pairings"};
+        r.soft_constraints = {"fairness", "seniority"};
+        sel = select_constraints(r);
+        assert(sel.hard == (constraint::always | constraint::legal_limits | constraint::skills));
+        assert(sel.fairness && !sel.preferences);
+        assert((sel.unknown == std::vector<std::string>{"pairings", "seniority"}));
+
+        r.hard_constraints = {"rest"}; // no hour cap
+        assert(select_constraints(r).hard == (constraint::always | constraint::rest));
+
+        // Names without bits keep the defaults
+        r.hard_constraints = {"coverage"};
+        assert(select_constraints(r).hard == constraint::defaults);
+        r.hard_constraints = {"coverage", "pairings"};
+        sel = select_constraints(r);
+        assert(sel.hard == constraint::defaults && sel.unknown.size() == 2);
+
+        // legal_limits is hours and rest; consecutive days must be named
+        r.hard_constraints = {"legal_limits"};
+        assert(select_constraints(r).hard == (constraint::always | constraint::weekly_hours | constraint::rest));
+        r.hard_constraints = {"legal_limits", "consecutive_days"};
+        assert(select_constraints(r).hard ==
+               (constraint::always | constraint::weekly_hours | constraint::rest | constraint::consecutive_days));
+    }
+
+    // ---- Test 14: consecutive_days and skills filter, unknown names warn ----
+    {
+        InputModel m;
+        Staff a;
+        a.id = "a";
+        a.role = "RN";
+        a.min_rest = 0;
+        a.max_consecutive_days = 3;
+        a.skills = {"vent"};
+        Staff b = a;
+        b.id = "b";
+        b.skills = {};
+        m.staff = {a, b};
+
+        // Four day shifts in a row plus one that needs a skill only "a" has
+        for (int d = 1; d <= 4; ++d) {
+            Shifts sh;
+            sh.id = "d" + std::to_string(d);
+            sh.name = "ICU";
+            sh.req_role = "RN";
+            sh.required_count = 2;
+            sh.start = make_time(2025, 4, d, 7, 0);
+            sh.end   = make_time(2025, 4, d, 15, 0);
+            m.shifts.push_back(sh);
+        }
+        Shifts vent = m.shifts[0];
+        vent.id = "vent";
+        vent.required_count = 1;
+        vent.req_skills = {"vent"};
+        vent.start = make_time(2025, 4, 6, 7, 0);
+        vent.end   = make_time(2025, 4, 6, 15, 0);
+        m.shifts.push_back(vent);
+        index_shifts(m);
+
+        // Defaults: neither consecutive days nor skills are enforced
+        auto res = build_schedule(m, EngineOptions{});
+        assert(res.warnings.empty());
+        assert(res.staff_count(3) == 2);
+
+        m.rules.hard_constraints = {"legal_limits", "consecutive_days", "skills", "pairings"};
+        for (bool diag : {false, true}) {
+            EngineOptions opt;
+            opt.diagnostics = diag;
+            res = build_schedule(m, opt);
+            auto asgs = to_assignments(m, res);
+            assert(asgs[3].shift_id == "d4" && asgs[3].staff_ids.empty()); // both on a 4th day
+            assert(asgs[4].shift_id == "vent" && asgs[4].staff_ids.size() == 1 && asgs[4].staff_ids[0] == "a");
+            assert(res.warnings.size() == 2);
+            assert(res.warnings[0] == "Unknown constraint 'pairings' ignored");
+            assert(res.warnings[1] == "No eligible staff for shift d4 (ICU)");
+#if HOS_DIAGNOSTICS
+            if (diag) {
+                assert(res.diagnostics[3].rejected_consecutive_days == 2);
+                assert(res.diagnostics[4].rejected_skills == 1 && res.diagnostics[4].eligible == 1);
+            }
+#endif
+        }
+    }
+
+    // ---- Test 15: scarcity order staffs the critical shift first, rest checked both ways ----
+    {
+        InputModel m;
+        Staff a;
+        a.id = "a";
+        a.role = "RN";
+        a.min_rest = 12;
+        Staff b = a;
+        b.id = "b";
+        b.availability.push_back({DateStamp{2025, 4, 2}, false});
+        m.staff = {a, b};
+
+        // "a" is the only one who can work s2, which starts 10h after s1 ends
+        Shifts s1;
+        s1.id = "s1";
+        s1.name = "ICU";
+        s1.req_role = "RN";
+        s1.required_count = 1;
+        s1.start = make_time(2025, 4, 1, 7, 0);
+        s1.end   = make_time(2025, 4, 1, 19, 0);
+        Shifts s2 = s1;
+        s2.id = "s2";
+        s2.start = make_time(2025, 4, 2, 5, 0);
+        s2.end   = make_time(2025, 4, 2, 17, 0);
+        m.shifts = {s2, s1};
+        index_shifts(m);
+
+        auto by_start = to_assignments(m, build_schedule(m));
+        assert(by_start[0].staff_ids[0] == "a" && by_start[1].staff_ids.empty());
+
+        for (bool diag : {false, true}) {
+            EngineOptions opt;
+            opt.shift_order = ShiftOrder::Scarcity;
+            opt.diagnostics = diag;
+            auto res = build_schedule(m, opt);
+            auto asgs = to_assignments(m, res);
+            assert(asgs[0].shift_id == "s1" && asgs[1].shift_id == "s2"); // listed in start order
+            assert(asgs[0].staff_ids.size() == 1 && asgs[0].staff_ids[0] == "b");
+            assert(asgs[1].staff_ids.size() == 1 && asgs[1].staff_ids[0] == "a");
+            assert(res.warnings.empty());
+        }
+
+        // "c" can only work s1, so s2 is still the scarcer one: "a" takes it first and is then
+        // rejected for s1 by the rest it needs before s2
+        Staff c = a;
+        c.id = "c";
+        c.availability.push_back({DateStamp{2025, 4, 2}, false});
+        m.staff[1].availability.push_back({DateStamp{2025, 4, 1}, false});
+        m.staff.push_back(c);
+        EngineOptions opt;
+        opt.shift_order = ShiftOrder::Scarcity;
+        opt.diagnostics = true;
+        auto res = build_schedule(m, opt);
+        auto asgs = to_assignments(m, res);
+        assert(asgs[0].staff_ids.size() == 1 && asgs[0].staff_ids[0] == "c");
+        assert(asgs[1].staff_ids.size() == 1 && asgs[1].staff_ids[0] == "a");
+#if HOS_DIAGNOSTICS
+        assert(res.diagnostics[0].shift_id == "s1" && res.diagnostics[0].rejected_rest == 1);
+        assert(res.diagnostics[0].rejected_availability == 1 && res.diagnostics[0].eligible == 1);
+#endif
+
+        // Random rosters: same entries in the same order, never over-staffed
+        for (unsigned seed = 1; seed <= 5; ++seed) {
+            InputModel r = make_random_model(seed);
+            EngineOptions scarce;
+            scarce.shift_order = ShiftOrder::Scarcity;
+            auto x = build_schedule(r, scarce);
+            assert(x.shift_index == build_schedule(r).shift_index);
+            for (size_t k = 0; k < x.shift_count(); ++k) {
+                assert(x.staff_count(k) <= static_cast<size_t>(std::max<int>(0, r.shifts[x.shift_index[k]].required_count)));
+            }
+        }
+    }
+
     std::cout << "engine_tests: all tests passed.\n";
     return 0;
 }
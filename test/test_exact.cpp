@@ -0,0 +1,160 @@
+#include "../src/model.hpp"
+#include "../src/engine.hpp"
+#include "../src/exact.hpp"
+#include "test_util.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+// Every hard rule of the unit, checked on a whole schedule
+static bool feasible(const ExactUnit& u, const std::vector<std::uint64_t>& staffed) {
+    for (size_t w = 0; w < u.workers.size(); ++w) {
+        const auto& wk = u.workers[w];
+        std::int64_t minutes = 0;
+        std::vector<bool> days(static_cast<size_t>(u.days), false);
+        const ExactUnit::Shift* prev = nullptr;
+        for (size_t i = 0; i < u.shifts.size(); ++i) {
+            const auto& sh = u.shifts[i];
+            if (!((staffed[i] >> w) & 1u)) continue;
+            if (!((sh.eligible >> w) & 1u)) return false;
+            if (prev && std::int64_t{sh.start} - prev->end < wk.rest) return false;
+            minutes += sh.duration();
+            days[static_cast<size_t>(sh.day)] = true;
+            prev = &sh;
+        }
+        if (minutes > wk.cap) return false;
+        int run = 0;
+        for (bool d : days) {
+            run = d ? run + 1 : 0;
+            if (run > wk.max_consecutive) return false;
+        }
+    }
+    for (size_t i = 0; i < u.shifts.size(); ++i) {
+        if (__builtin_popcountll(staffed[i]) > u.shifts[i].required) return false;
+    }
+    return true;
+}
+
+// Best objective by trying every assignment
+static void brute_force(const ExactUnit& u, std::vector<std::uint64_t>& staffed, size_t i, ExactObjective& best) {
+    if (i == u.shifts.size()) {
+        if (!feasible(u, staffed)) return;
+        const ExactObjective obj = evaluate_exact(u, staffed);
+        if (obj < best) best = obj;
+        return;
+    }
+    const std::uint64_t all = (std::uint64_t{1} << u.workers.size()) - 1;
+    for (std::uint64_t mask = 0; mask <= all; ++mask) {
+        if ((mask & ~u.shifts[i].eligible) || __builtin_popcountll(mask) > u.shifts[i].required) continue;
+        staffed[i] = mask;
+        brute_force(u, staffed, i + 1, best);
+    }
+    staffed[i] = 0;
+}
+
+int main() {
+    // ---- Test 1: same optimum as exhaustive search on small random units ----
+    {
+        unsigned state = 7;
+        auto next = [&](unsigned mod) { state = state * 1103515245u + 12345u; return (state >> 16) % mod; };
+        for (int round = 0; round < 60; ++round) {
+            ExactUnit u;
+            u.days = 4;
+            u.fairness = round % 3 != 0;
+            u.preferences = round % 4 != 0;
+            const size_t workers = 2 + next(3);
+            for (size_t w = 0; w < workers; ++w) {
+                ExactUnit::Worker wk;
+                wk.cap = 60 * static_cast<std::int32_t>(8 + 4 * next(5));
+                wk.rest = round % 5 == 0 ? INT32_MIN : 60 * static_cast<std::int32_t>(next(13));
+                wk.max_consecutive = 1 + static_cast<std::int32_t>(next(3));
+                u.workers.push_back(wk);
+            }
+            const size_t shifts = 3 + next(4);
+            std::vector<std::int32_t> starts;
+            for (size_t i = 0; i < shifts; ++i) starts.push_back(static_cast<std::int32_t>(60 * next(24 * 4)));
+            std::sort(starts.begin(), starts.end());
+            for (std::int32_t start : starts) {
+                ExactUnit::Shift sh;
+                sh.start = start;
+                sh.end = start + 60 * static_cast<std::int32_t>(4 + next(9));
+                sh.day = start / (24 * 60);
+                sh.required = static_cast<std::int32_t>(next(3));
+                for (size_t w = 0; w < workers; ++w) {
+                    if (next(5) != 0 && u.workers[w].cap >= sh.duration()) sh.eligible |= std::uint64_t{1} << w;
+                    if (next(3) == 0) sh.penalized |= std::uint64_t{1} << w;
+                }
+                u.shifts.push_back(sh);
+            }
+
+            std::vector<std::uint64_t> staffed(shifts, 0);
+            ExactObjective best = evaluate_exact(u, staffed); // staffing nobody is always allowed
+            brute_force(u, staffed, 0, best);
+
+            const ExactSolution sol = solve_exact(u, std::vector<std::uint64_t>(shifts, 0));
+            assert(sol.optimal);
+            assert(feasible(u, sol.staffed));
+            assert(!(sol.objective < best) && !(best < sol.objective));
+            const ExactObjective check = evaluate_exact(u, sol.staffed);
+            assert(!(check < sol.objective) && !(sol.objective < check));
+        }
+    }
+
+    // ---- Test 2: engine exact mode undoes a greedy trap and recounts the result ----
+    {
+        InputModel m;
+        for (const char* id : {"a", "b"}) {
+            Staff s;
+            s.id = id;
+            s.role = "RN";
+            m.staff.push_back(s);
+        }
+        m.staff[0].max_weekly_hours = 16;
+        m.staff[1].max_weekly_hours = 8;
+        Shifts day;
+        day.id = "day";
+        day.name = "ICU";
+        day.req_role = "RN";
+        day.start = make_time(2025, 4, 1, 7, 0);
+        day.end = make_time(2025, 4, 1, 15, 0);
+        Shifts dbl = day;
+        dbl.id = "double";
+        dbl.start = make_time(2025, 4, 3, 7, 0);
+        dbl.end = make_time(2025, 4, 3, 23, 0);
+        m.shifts = {day, dbl};
+        index_shifts(m);
+
+        // Greedy gives "day" to a (same hours, id order), who then cannot fit 16 more hours
+        const ScheduleResult greedy = build_schedule(m);
+        assert(greedy.staff_count(1) == 0 && greedy.warnings.size() == 1 && greedy.exact.empty());
+
+        EngineOptions opt;
+        opt.exact.enabled = true;
+        const ScheduleResult r = build_schedule(m, opt);
+        assert(r.staff_count(0) == 1 && r.staff_begin(0)[0] == 1);
+        assert(r.staff_count(1) == 1 && r.staff_begin(1)[0] == 0);
+        assert(r.warnings.empty());
+        assert(r.staff_totals[0].minutes == 16 * 60 && r.staff_totals[1].minutes == 8 * 60);
+        assert(r.staff_totals[0].shifts == 1 && r.staff_totals[0].nights == 0);
+        assert(r.exact.size() == 1);
+        const ExactComponent& c = r.exact[0];
+        assert(c.role == "RN" && c.staff == 2 && c.shifts == 2);
+        assert(c.searched && c.optimal && c.improved && c.greedy_shortfall == 1 && c.shortfall == 0);
+
+        // Too large for the limits: reported, greedy kept
+        opt.exact.max_staff = 1;
+        const ScheduleResult kept = build_schedule(m, opt);
+        assert(kept.exact.size() == 1 && !kept.exact[0].searched && kept.exact[0].shortfall == 1);
+        assert(kept.staff_count(1) == 0 && kept.warnings == greedy.warnings);
+
+        // Out of nodes before anything better: not optimal, greedy kept
+        opt.exact.max_staff = 40;
+        opt.exact.node_limit = 1;
+        const ScheduleResult cut = build_schedule(m, opt);
+        assert(cut.exact[0].searched && !cut.exact[0].optimal && !cut.exact[0].improved);
+        assert(cut.staff_index == greedy.staff_index);
+    }
+
+    std::cout << "exact_tests: all tests passed.\n";
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include "../src/input_parser.hpp"
 #include <cassert>
 #include <iostream>
+#include <stdexcept>
 
 int main() {
     // Sample JSON similar to our structure
@@ -32,6 +33,7 @@ int main() {
       "start": "2025-04-01T07:00",
       "end": "2025-04-01T19:00",
       "required_role": "RN",
+      "required_skills": ["ICU"],
       "required_count": 3
     },
     {
@@ -78,6 +80,11 @@ int main() {
         assert(model.shifts.size() == 2);
         assert(model.shifts[0].id == "shift1");
         assert(model.shifts[1].id == "shift2");
+        assert(model.shifts[0].req_skills.size() == 1 && model.shifts[0].req_skills[0] == "ICU");
+        assert(model.shifts[1].req_skills.empty());
+        // same start: input order kept
+        assert(model.shift_order.size() == 2);
+        assert(model.shift_order[0] == 0 && model.shift_order[1] == 1);
 
         // rules
         assert(model.rules.max_hours_per_week_default == 40);
@@ -97,6 +104,43 @@ int main() {
         assert(model.shifts[0].name == "ICU");
     }
 
+    // --- Test 3: shifts are read once, whatever the staff count ---
+    {
+        const char* text = R"json(
+{
+  "staff": [
+    { "id": "a", "role": "RN" },
+    { "id": "b", "role": "RN" },
+    { "id": "c", "role": "LPN" }
+  ],
+  "shifts": [
+    { "id": "x1", "name": "ICU", "start": "2025-04-01T07:00", "end": "2025-04-01T19:00", "required_role": "RN", "required_count": 1 },
+    { "id": "x2", "name": "ER", "start": "2025-04-02T07:00", "end": "2025-04-02T19:00", "required_role": "LPN", "required_count": 1 }
+  ]
+}
+)json";
+        auto model = parse_input_json(text, Filters{});
+        assert(model.staff.size() == 3);
+        assert(model.shifts.size() == 2);
+        assert(model.shift_order.size() == 2);
+        assert(model.shifts[0].id == "x1" && model.shifts[1].id == "x2");
+    }
+
+    // --- Test 4: errors surface as std::exception ---
+    {
+        bool threw = false;
+        try { parse_input_json("{ \"staff\": [ ", Filters{}); } catch (const std::exception&) { threw = true; }
+        assert(threw); // malformed JSON
+
+        threw = false;
+        try { parse_input_json(R"({"shifts": []})", Filters{}); } catch (const std::exception&) { threw = true; }
+        assert(threw); // missing staff array
+
+        threw = false;
+        try { parse_input_json(R"({"staff": [{"id": 7}], "shifts": []})", Filters{}); } catch (const std::exception&) { threw = true; }
+        assert(threw); // id is not a string
+    }
+
     std::cout << "parser_tests: all tests passed.\n";
     return 0;
 }
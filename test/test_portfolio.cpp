@@ -0,0 +1,123 @@
+#include "../src/model.hpp"
+#include "../src/engine.hpp"
+#include "../src/portfolio.hpp"
+#include "test_util.hpp"
+#include <cassert>
+#include <iostream>
+
+// Nurse with room for a few 12 h shifts a week
+static Staff make_nurse(const std::string& id) {
+    Staff s = make_staff(id, "RN");
+    s.max_weekly_hours = 48;
+    return s;
+}
+
+// Id order is the unlucky one: "a" takes the first shift, then has too little rest for the
+// second, and "b" is off that day. Staffing them the other way round covers both.
+static InputModel make_trap() {
+    InputModel m;
+    m.staff.push_back(make_nurse("a"));
+    m.staff.push_back(make_nurse("b"));
+    m.staff[1].availability.push_back({DateStamp{2025, 4, 2}, false});
+    m.shifts.push_back(make_shift("s1", "RN", 1, 7, 12, 1));
+    m.shifts.push_back(make_shift("s2", "RN", 2, 5, 12, 1));
+    index_shifts(m);
+    return m;
+}
+
+// Same-start shifts in two units with more staff than slots
+static InputModel make_wide() {
+    InputModel m;
+    for (int i = 0; i < 12; ++i) {
+        m.staff.push_back(make_nurse("n" + std::to_string(i)));
+        if (i % 3 == 0) m.staff.back().prefs.avoid_nights = true;
+        if (i % 4 == 1) m.staff.back().availability.push_back({DateStamp{2025, 4, 1 + i % 5}, false});
+    }
+    for (int d = 1; d <= 7; ++d) {
+        for (int h : {7, 19}) {
+            for (const char* unit : {"ICU", "ER"}) {
+                Shifts sh = make_shift(std::string(unit) + std::to_string(d) + "_" + std::to_string(h), "RN", d, h, 12, 2);
+                sh.name = unit;
+                m.shifts.push_back(sh);
+            }
+        }
+    }
+    index_shifts(m);
+    return m;
+}
+
+int main() {
+    // ---- Test 1: the plain pass is build_schedule; a random pass escapes the trap ----
+    {
+        const InputModel m = make_trap();
+        const ScheduleResult plain = build_schedule(m);
+        assert(score_schedule(m, plain).shortfall_slots == 1);
+
+        PortfolioOptions opt;
+        opt.passes = 16;
+        PortfolioResult pr = run_portfolio(m, opt);
+        assert(pr.scores.size() == 16);
+        assert(pr.scores[0].total == score_schedule(m, plain).total);
+        assert(pr.best_pass != 0 && pr.best_score.shortfall_slots == 0);
+        assert(pr.best.staff_count(0) == 1 && pr.best.staff_count(1) == 1);
+        assert(pr.best.staff_index[0] == 1 && pr.best.staff_index[1] == 0); // b then a
+    }
+
+    // ---- Test 2: same seed, same winner on any thread count; never worse than plain ----
+    {
+        const InputModel m = make_wide();
+        PortfolioOptions opt;
+        opt.passes = 12;
+        opt.seed = 99;
+        opt.threads = 1;
+        PortfolioResult one = run_portfolio(m, opt);
+        opt.threads = 4;
+        PortfolioResult four = run_portfolio(m, opt);
+
+        assert(one.best_pass == four.best_pass && one.best_score.total == four.best_score.total);
+        assert(one.best.shift_index == four.best.shift_index);
+        assert(one.best.staff_index == four.best.staff_index);
+        for (size_t p = 0; p < one.scores.size(); ++p) {
+            assert(one.scores[p].total == four.scores[p].total);
+            assert(one.best_score.total <= one.scores[p].total);
+        }
+
+        // Seeded passes really differ from each other and keep start order
+        bool any_differs = false;
+        for (std::uint64_t seed : {3u, 5u, 7u}) {
+            EngineOptions eo;
+            eo.tie_seed = seed;
+            ScheduleResult r = build_schedule(m, eo);
+            assert(r.shift_count() == m.shifts.size());
+            for (size_t k = 1; k < r.shift_count(); ++k) {
+                assert(m.shifts[r.shift_index[k - 1]].start <= m.shifts[r.shift_index[k]].start);
+            }
+            any_differs |= r.staff_index != one.best.staff_index || r.shift_index != one.best.shift_index;
+        }
+        assert(any_differs);
+    }
+
+    // ---- Test 3: the objective weighs its terms ----
+    {
+        const InputModel m = make_wide();
+        const ScheduleResult r = build_schedule(m);
+        ObjectiveWeights only_prefs{0.0, 0.0, 1.0};
+        ScheduleScore s = score_schedule(m, r, only_prefs);
+        assert(s.total == static_cast<double>(s.preference_violations));
+        ObjectiveWeights only_var{0.0, 2.0, 0.0};
+        assert(score_schedule(m, r, only_var).total == 2.0 * s.hours_variance);
+
+        // Soft constraints the rules turn off don't rank the passes
+        InputModel fair_only = m;
+        fair_only.rules.soft_constraints = {"fairness"};
+        PortfolioOptions opt;
+        opt.passes = 6;
+        opt.weights = only_prefs;
+        const PortfolioResult pr = run_portfolio(fair_only, opt);
+        assert(s.preference_violations > 0 && pr.best_pass == 0);
+        for (const auto& sc : pr.scores) assert(sc.total == 0.0);
+    }
+
+    std::cout << "portfolio_tests: all tests passed.\n";
+    return 0;
+}
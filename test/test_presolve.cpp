@@ -0,0 +1,146 @@
+#include "../src/model.hpp"
+#include "../src/engine.hpp"
+#include "../src/presolve.hpp"
+#include "test_util.hpp"
+#include <cassert>
+#include <iostream>
+
+static long shortfall_of(const InputModel& m, const ScheduleResult& r) {
+    long short_by = 0;
+    for (size_t k = 0; k < r.shift_count(); ++k) {
+        short_by += std::max<long>(0, m.shifts[r.shift_index[k]].required_count - static_cast<long>(r.staff_count(k)));
+    }
+    return short_by;
+}
+
+static const PresolveRole& role_of(const PresolveReport& rep, const std::string& role) {
+    for (const auto& r : rep.roles) {
+        if (r.role == role) return r;
+    }
+    assert(false && "role missing from the report");
+    return rep.roles.front();
+}
+
+int main() {
+    // ---- Test 1: concurrent shifts need distinct staff; matching sees the skill bottleneck ----
+    {
+        InputModel m;
+        for (int i = 0; i < 5; ++i) m.staff.push_back(make_staff("n" + std::to_string(i), "RN"));
+        m.staff[0].skills = {"vent"};
+        m.staff[1].skills = {"vent"};
+        m.staff[2].availability.push_back({DateStamp{2025, 4, 1}, false});
+        for (int i = 0; i < 3; ++i) {
+            m.shifts.push_back(make_shift("v" + std::to_string(i), "RN", 1, 7 + i, 8, 1));
+            m.shifts.back().req_skills = {"vent"};
+        }
+        m.shifts.push_back(make_shift("w", "RN", 1, 8, 8, 1));
+        m.shifts.push_back(make_shift("md", "MD", 3, 7, 8, 2)); // no staff has the role
+        index_shifts(m);
+
+        // Skills not selected: 4 available nurses for 4 overlapping slots
+        m.rules.hard_constraints = {"coverage", "legal_limits"};
+        PresolveReport rep = presolve(m);
+        assert(rep.required_slots == 6);
+        assert(role_of(rep, "RN").shortfall == 0 && role_of(rep, "RN").staff == 5);
+        assert(role_of(rep, "MD").shortfall == 2 && role_of(rep, "MD").staff == 0);
+        assert(rep.unavoidable_shortfall == 2);
+        assert(rep.slices.size() == 1 && rep.slices[0].role == "MD" && rep.slices[0].supply == 0);
+
+        // With skills only two nurses can take the three vent shifts, though counts alone pass
+        m.rules.hard_constraints = {"coverage", "legal_limits", "skills"};
+        rep = presolve(m);
+        const PresolveRole& rn = role_of(rep, "RN");
+        assert(rn.slice_bound == 1 && rn.shortfall == 1);
+        assert(rep.unavoidable_shortfall == 3 && rep.slices.size() == 2);
+        for (const auto& s : rep.slices) {
+            if (s.role != "RN") continue;
+            assert(s.shifts == 4 && s.demand == 4 && s.supply == 3 && s.shortfall == 1);
+            assert(s.start == m.shifts[0].start && s.end == m.shifts[2].end);
+        }
+        assert(shortfall_of(m, build_schedule(m)) >= rep.unavoidable_shortfall);
+    }
+
+    // ---- Test 2: rest joins shifts into one slice; hour caps bound the total ----
+    {
+        InputModel m;
+        m.staff.push_back(make_staff("a", "RN"));
+        m.staff.push_back(make_staff("b", "RN"));
+        m.staff[0].max_weekly_hours = 16;
+        m.staff[1].max_weekly_hours = 16;
+        // Day and night back to back, three slots: two nurses with 12h rest cover two
+        m.shifts.push_back(make_shift("day", "RN", 1, 7, 8, 2));
+        m.shifts.push_back(make_shift("eve", "RN", 1, 15, 8, 1));
+        // Far apart, but the caps (32h) cannot also cover 3 more 8h slots
+        m.shifts.push_back(make_shift("d5", "RN", 5, 7, 8, 1));
+        m.shifts.push_back(make_shift("d8", "RN", 8, 7, 8, 1));
+        m.shifts.push_back(make_shift("d11", "RN", 11, 7, 8, 1));
+        index_shifts(m);
+
+        PresolveReport rep = presolve(m);
+        const PresolveRole& rn = role_of(rep, "RN");
+        assert(rn.slice_bound == 1);
+        assert(rn.hours_bound == 2); // 48h needed, 32h available: at least 2 eight-hour slots
+        assert(rn.shortfall == 2 && rep.unavoidable_shortfall == 2);
+        assert(shortfall_of(m, build_schedule(m)) >= 2);
+
+        // Without legal limits neither rest nor caps apply: day and eve no longer share a slice
+        m.rules.hard_constraints = {"role", "availability"};
+        rep = presolve(m);
+        assert(rep.unavoidable_shortfall == 0 && rep.slices.empty());
+    }
+
+    // ---- Test 3: never above what the engine actually leaves short ----
+    {
+        for (unsigned seed = 1; seed <= 20; ++seed) {
+            unsigned state = seed;
+            auto next = [&](unsigned mod) { state = state * 1103515245u + 12345u; return (state >> 16) % mod; };
+            const char* roles[] = {"RN", "LPN"};
+            InputModel m;
+            for (int i = 0; i < 12; ++i) {
+                Staff s = make_staff("s" + std::to_string(i), roles[next(2)]);
+                s.max_weekly_hours = static_cast<short>(8 + next(40));
+                s.min_rest = static_cast<short>(next(13));
+                if (next(3) == 0) s.skills = {"vent"};
+                for (int d = 1; d <= 7; ++d) {
+                    if (next(5) == 0) s.availability.push_back({DateStamp{2025, 4, d}, false});
+                }
+                m.staff.push_back(s);
+            }
+            for (int i = 0; i < 40; ++i) {
+                Shifts sh = make_shift("x" + std::to_string(i), roles[next(2)], 1 + static_cast<int>(next(7)),
+                                       static_cast<int>(next(24)), 4 + static_cast<int>(next(9)), static_cast<int>(next(4)));
+                if (next(4) == 0) sh.req_skills = {"vent"};
+                m.shifts.push_back(sh);
+            }
+            index_shifts(m);
+            for (const char* limits : {"legal_limits", "weekly_hours"}) {
+                m.rules.hard_constraints = {"coverage", limits, "skills"};
+                const PresolveReport rep = presolve(m);
+                for (bool fairness : {true, false}) {
+                    EngineOptions opt;
+                    opt.fairness_on = fairness;
+                    assert(shortfall_of(m, build_schedule(m, opt)) >= rep.unavoidable_shortfall);
+                }
+            }
+        }
+    }
+
+    // ---- Test 4: without rest, one worker may take overlapping shifts ----
+    {
+        InputModel m;
+        m.staff = {make_staff("a", "RN")};
+        m.shifts = {make_shift("x", "RN", 1, 7, 8, 1), make_shift("y", "RN", 1, 9, 8, 1)};
+        index_shifts(m);
+        m.rules.hard_constraints = {"role", "availability", "weekly_hours"};
+        const PresolveReport rep = presolve(m);
+        assert(rep.unavoidable_shortfall == 0 && rep.slices.empty());
+        assert(shortfall_of(m, build_schedule(m)) == 0);
+
+        m.rules.hard_constraints = {"coverage", "legal_limits"};
+        const PresolveReport rested = presolve(m);
+        assert(rested.unavoidable_shortfall == 1 && rested.slices.size() == 1 && rested.slices[0].shifts == 2);
+    }
+
+    std::cout << "presolve_tests: all tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include "../src/model.hpp"
+#include "../src/engine.hpp"
+#include "../src/scenario.hpp"
+#include "../src/input_parser.hpp"
+#include "../src/csv_writer.hpp"
+#include "test_util.hpp"
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+// Two units over a week, slightly understaffed
+static InputModel make_model() {
+    InputModel m;
+    for (int i = 0; i < 6; ++i) {
+        Staff s;
+        s.id = "n" + std::to_string(i);
+        s.role = "RN";
+        s.max_weekly_hours = 24;
+        s.min_rest = 8;
+        s.prefs.avoid_nights = i % 3 == 0;
+        if (i % 2) s.prefs.preferred_unit = {"ER"};
+        m.staff.push_back(s);
+    }
+    for (int d = 1; d <= 7; ++d) {
+        for (const char* unit : {"ICU", "ER"}) {
+            for (int h : {7, 19}) {
+                Shifts sh;
+                sh.id = std::string(unit) + "_" + std::to_string(d) + "_" + std::to_string(h);
+                sh.name = unit;
+                sh.req_role = "RN";
+                sh.required_count = 1;
+                sh.start = make_time(2025, 4, d, h, 0);
+                sh.end   = make_time(2025, 4, d, h + 12, 0);
+                m.shifts.push_back(sh);
+            }
+        }
+    }
+    index_shifts(m);
+    return m;
+}
+
+static void assert_same_metrics(const ScenarioMetrics& a, const ScenarioMetrics& b) {
+    assert(a.staff == b.staff && a.shifts == b.shifts);
+    assert(a.required_slots == b.required_slots && a.filled_slots == b.filled_slots);
+    assert(a.short_shifts == b.short_shifts && a.warnings == b.warnings);
+    assert(a.mean_hours == b.mean_hours && a.stddev_hours == b.stddev_hours);
+    assert(a.preference_violations == b.preference_violations);
+}
+
+int main() {
+    auto base = std::make_shared<const InputModel>(make_model());
+
+    // ---- Test 1: overlays copy the model only when they change it ----
+    {
+        ScenarioOverlay opts_only;
+        opts_only.fairness_on = false;
+        assert(apply_overlay(base, opts_only) == base);
+
+        ScenarioOverlay closed;
+        closed.closed_units = {"ER"};
+        auto m = apply_overlay(base, closed);
+        assert(m != base);
+        assert(m->shifts.size() == 14 && m->shift_order.size() == 14);
+        assert(base->shifts.size() == 28); // base untouched
+
+        ScenarioOverlay grow;
+        grow.max_weekly_hours = 60;
+        grow.extra_staff.resize(1);
+        grow.extra_staff[0].id = "agency";
+        grow.extra_staff[0].role = "RN";
+        m = apply_overlay(base, grow);
+        assert(m->staff.size() == 7 && m->staff[0].max_weekly_hours == 60);
+        assert(base->staff.size() == 6 && base->staff[0].max_weekly_hours == 24);
+    }
+
+    // ---- Test 2: parallel run matches scheduling each scenario on its own ----
+    {
+        const std::string text = R"json({"scenarios": [
+            {"name": "no_fairness", "fairness": false},
+            {"name": "no_prefs", "preferences": false},
+            {"name": "cap_36", "max_weekly_hours": 36},
+            {"name": "agency", "add_staff": [{"id": "ag1", "role": "RN"}]},
+            {"name": "icu_only", "close_units": ["ER"]}
+        ]})json";
+        std::vector<ScenarioOverlay> overlays(1);
+        overlays[0].name = "base";
+        for (auto& ov : parse_scenarios_json(text, base->rules)) overlays.push_back(std::move(ov));
+        assert(overlays.size() == 6);
+        assert(overlays[4].extra_staff[0].max_weekly_hours == base->rules.max_hours_per_week_default);
+
+        auto metrics = run_scenarios(base, overlays, EngineOptions{}, 4);
+        assert(metrics.size() == overlays.size());
+        for (size_t i = 0; i < overlays.size(); ++i) {
+            auto model = apply_overlay(base, overlays[i]);
+            EngineOptions opt;
+            if (overlays[i].fairness_on) opt.fairness_on = *overlays[i].fairness_on;
+            if (overlays[i].respect_preferences) opt.respect_preferences = *overlays[i].respect_preferences;
+            ScenarioMetrics serial = measure_schedule(*model, build_schedule(*model, opt));
+            assert(metrics[i].name == overlays[i].name);
+            assert_same_metrics(metrics[i], serial);
+        }
+
+        // 6 nurses x 24h cannot cover 28 twelve-hour shifts; more hours or fewer shifts help
+        assert(metrics[0].short_shifts > 0 && metrics[0].coverage_pct < 100.0);
+        assert(metrics[3].filled_slots > metrics[0].filled_slots);
+        assert(metrics[5].shifts == 14);
+    }
+
+    // ---- Test 3: scenario names are quoted in the CSV when they need it ----
+    {
+        std::vector<ScenarioMetrics> rows(3);
+        rows[0].name = "base";
+        rows[1].name = "cap 36, \"strict\"";
+        rows[2].name = "two\nlines";
+        std::ostringstream csv;
+        write_scenarios_csv(rows, csv);
+        const std::string text = csv.str();
+        assert(text.find("\nbase,0,") != std::string::npos);
+        assert(text.find("\n\"cap 36, \"\"strict\"\"\",0,") != std::string::npos);
+        assert(text.find("\n\"two\nlines\",0,") != std::string::npos);
+    }
+
+    std::cout << "scenario_tests: all tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include "../src/model.hpp"
+#include "../src/engine.hpp"
+#include "../src/score.hpp"
+#include "../src/scenario.hpp"
+#include "../src/input_parser.hpp"
+#include "test_util.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+static bool near(double a, double b) { return std::abs(a - b) < 1e-9; }
+
+int main() {
+    // Three shifts needing 2, 1 and 0 staff; the result staffs one of each of the first two
+    InputModel m;
+    for (int i = 0; i < 3; ++i) {
+        Shifts sh;
+        sh.id = "x" + std::to_string(i);
+        sh.required_count = static_cast<short>(2 - i);
+        sh.start = make_time(2025, 4, 1 + i, 7, 0);
+        sh.end = sh.start + Hours(8);
+        m.shifts.push_back(sh);
+    }
+    m.staff.resize(3);
+    index_shifts(m);
+
+    ScheduleResult r;
+    r.shift_index = {0, 1, 2};
+    r.staff_offsets = {0, 1, 2, 2};
+    r.staff_index = {0, 1};
+    r.staff_totals.resize(3);
+    r.staff_totals[0].minutes = 8 * 60;
+    r.staff_totals[0].nights = 1;
+    r.staff_totals[0].preference_violations = 1;
+    r.staff_totals[1].minutes = 12 * 60;
+    r.staff_totals[2].nights = 2;
+
+    // ---- Test 1: every term from the flat arrays ----
+    {
+        const ObjectiveWeights w{1000.0, 1.0, 10.0, 3.0};
+        const ScheduleScore s = score_schedule(m, r, w);
+        assert(s.required_slots == 3 && s.filled_slots == 2 && s.shortfall_slots == 1 && s.short_shifts == 1);
+        assert(near(s.mean_hours, 20.0 / 3.0));
+        assert(near(s.hours_variance, (64.0 + 144.0) / 3.0 - 400.0 / 9.0));
+        assert(s.min_hours == 0.0 && s.max_hours == 12.0);
+        assert(s.preference_violations == 1);
+        assert(near(s.mean_nights, 1.0) && near(s.night_variance, 2.0 / 3.0) && s.max_nights == 2);
+        assert(near(s.total, 1000.0 + s.hours_variance + 10.0 + 2.0));
+
+        // Nobody scheduled: only the shortfall counts
+        ScheduleResult empty = r;
+        empty.staff_offsets = {0, 0, 0, 0};
+        empty.staff_index.clear();
+        empty.staff_totals.assign(3, StaffTotals{});
+        const ScheduleScore e = score_schedule(m, empty, w);
+        assert(e.shortfall_slots == 3 && e.short_shifts == 2 && e.total == 3000.0);
+    }
+
+    // ---- Test 2: weights come from the input's rules ----
+    {
+        InputModel weighted = m;
+        weighted.rules.objective = ObjectiveWeights{1.0, 0.0, 0.0, 6.0};
+        assert(near(score_schedule(weighted, r).total, 1.0 + 4.0));
+        assert(score_schedule(m, r).total == score_schedule(m, r, ObjectiveWeights{}).total);
+
+        // Soft constraints the rules leave out don't count
+        InputModel no_soft = weighted;
+        no_soft.rules.objective = ObjectiveWeights{1.0, 2.0, 10.0, 0.0};
+        no_soft.rules.soft_constraints = {"fairness"};
+        const ScheduleScore fair = score_schedule(no_soft, r);
+        assert(near(fair.total, 1.0 + 2.0 * fair.hours_variance) && fair.preference_violations == 1);
+        no_soft.rules.soft_constraints = {"preferences"};
+        assert(near(score_schedule(no_soft, r).total, 1.0 + 10.0));
+        const ObjectiveWeights masked = selected_weights(no_soft.rules, no_soft.rules.objective);
+        assert(masked.hours_variance == 0.0 && masked.preference == 10.0 && masked.shortfall == 1.0);
+
+        const InputModel parsed = parse_input_json(R"json({
+  "staff": [],
+  "shifts": [],
+  "rules": { "objective_weights": { "shortfall": 50, "night_variance": 2.5 } }
+})json");
+        assert(parsed.rules.objective.shortfall == 50.0 && parsed.rules.objective.night_variance == 2.5);
+        assert(parsed.rules.objective.hours_variance == ObjectiveWeights{}.hours_variance);
+        assert(parsed.rules.objective.preference == ObjectiveWeights{}.preference);
+    }
+
+    // ---- Test 3: what-if metrics are the same evaluation ----
+    {
+        const ScenarioMetrics sm = measure_schedule(m, r);
+        const ScheduleScore s = score_schedule(m, r);
+        assert(sm.required_slots == s.required_slots && sm.short_shifts == s.short_shifts);
+        assert(near(sm.stddev_hours, std::sqrt(s.hours_variance)) && near(sm.stddev_nights, std::sqrt(s.night_variance)));
+        assert(sm.score == s.total);
+    }
+
+    std::cout << "score_tests: all tests passed.\n";
+    return 0;
+}
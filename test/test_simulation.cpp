@@ -0,0 +1,190 @@
+#include "../src/model.hpp"
+#include "../src/engine.hpp"
+#include "../src/simulation.hpp"
+#include "../src/timeline.hpp"
+#include "test_util.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+// One unit over two weeks with some slack for repairs
+static InputModel make_model() {
+    InputModel m;
+    for (int i = 0; i < 10; ++i) {
+        Staff s;
+        s.id = "n" + std::to_string(i);
+        s.role = "RN";
+        s.max_weekly_hours = 96;
+        s.min_rest = 10;
+        m.staff.push_back(s);
+    }
+    m.staff[3].availability.push_back({DateStamp{2025, 4, 2}, false});
+    for (int d = 1; d <= 14; ++d) {
+        for (int h : {7, 19}) {
+            Shifts sh;
+            sh.id = "ICU_" + std::to_string(d) + "_" + std::to_string(h);
+            sh.name = "ICU";
+            sh.req_role = "RN";
+            sh.required_count = 2;
+            sh.start = make_time(2025, 4, d, h, 0);
+            sh.end   = make_time(2025, 4, d, h + 12, 0);
+            m.shifts.push_back(sh);
+        }
+    }
+    index_shifts(m);
+    return m;
+}
+
+static void assert_same(const Distribution& a, const Distribution& b) {
+    assert(a.mean == b.mean && a.min == b.min && a.max == b.max);
+    assert(a.p5 == b.p5 && a.p50 == b.p50 && a.p95 == b.p95 && a.p99 == b.p99);
+}
+
+int main() {
+    // ---- Test 1: timelines keep rest on both sides, in any insertion order ----
+    {
+        WorkerTimelines t;
+        t.reset(2, 2);
+        t.insert(0, 1000, 1720);
+        t.insert(0, 0, 720);
+        assert(t.size(0) == 2 && t.begin(0)->start == 0 && t.size(1) == 0);
+        assert(!t.fits(0, 700, 900, 0));          // overlaps the first
+        assert(t.fits(0, 720, 1000, 0));          // fills the gap exactly
+        assert(!t.fits(0, 800, 900, 120));        // too close to both
+        assert(t.fits(0, 2400, 3000, 600));       // after both with rest
+        assert(!t.fits(0, -500, -100, 600));      // before, but not enough rest
+        assert(t.fits(1, 800, 900, 600));         // other worker is free
+        assert(t.erase(0, 1000) && !t.erase(0, 1000));
+        assert(t.fits(0, 800, 900, 60));
+
+        // Past the expected count, ranges move and keep their order
+        for (int i = 20; i > 0; --i) t.insert(1, i * 100, i * 100 + 50);
+        t.insert(0, 5000, 5100);
+        assert(t.size(1) == 20 && t.size(0) == 2);
+        for (const auto* iv = t.begin(1) + 1; iv != t.end(1); ++iv) assert((iv - 1)->start < iv->start);
+        assert(t.begin(0)->start == 0 && (t.end(0) - 1)->start == 5000);
+    }
+
+    const InputModel model = make_model();
+    const ScheduleResult result = build_schedule(model);
+
+    // ---- Test 2: same seed, same report on any thread count ----
+    {
+        SimulationOptions opt;
+        opt.samples = 300;
+        opt.callout_rate = 0.1;
+        opt.seed = 42;
+        opt.threads = 1;
+        SimulationReport one = simulate_callouts(model, result, opt);
+        opt.threads = 4;
+        SimulationReport four = simulate_callouts(model, result, opt);
+        assert(one.samples == 300 && four.samples == 300);
+        assert(one.required_slots == 56 && one.required_slots == four.required_slots);
+        assert_same(one.vacated_slots, four.vacated_slots);
+        assert_same(one.repaired_slots, four.repaired_slots);
+        assert_same(one.uncovered_slots, four.uncovered_slots);
+        assert_same(one.coverage_pct, four.coverage_pct);
+
+        // Call-outs happen, repairs recover some of them, never more than were lost
+        assert(one.vacated_slots.mean > 0);
+        assert(one.repaired_slots.mean > 0 && one.repaired_slots.max <= one.vacated_slots.max);
+        assert(one.uncovered_slots.min >= one.baseline_uncovered_slots);
+        assert(one.vacated_slots.min <= one.vacated_slots.p50 && one.vacated_slots.p50 <= one.vacated_slots.p99);
+
+        opt.seed = 43;
+        SimulationReport other = simulate_callouts(model, result, opt);
+        assert(other.vacated_slots.mean != one.vacated_slots.mean);
+    }
+
+    // ---- Test 3: edge rates ----
+    {
+        SimulationOptions opt;
+        opt.samples = 50;
+        opt.callout_rate = 0.0;
+        SimulationReport none = simulate_callouts(model, result, opt);
+        assert(none.vacated_slots.max == 0 && none.repaired_slots.max == 0);
+        assert(none.uncovered_slots.min == none.baseline_uncovered_slots);
+        assert(none.uncovered_slots.max == none.baseline_uncovered_slots);
+
+        long filled = 0;
+        for (size_t k = 0; k < result.shift_count(); ++k) filled += static_cast<long>(result.staff_count(k));
+        opt.callout_rate = 1.0;
+        SimulationReport all = simulate_callouts(model, result, opt);
+        assert(all.vacated_slots.min == filled && all.repaired_slots.max == 0);
+        assert(all.uncovered_slots.min == all.required_slots && all.coverage_pct.max == 0.0);
+
+        // Just under 1 and past 1: no overflow in the draw threshold
+        opt.callout_rate = std::nextafter(1.0, 0.0);
+        SimulationReport almost = simulate_callouts(model, result, opt);
+        assert(almost.vacated_slots.min == filled);
+        opt.callout_rate = 1.5;
+        SimulationReport over = simulate_callouts(model, result, opt);
+        assert(over.vacated_slots.min == filled && over.repaired_slots.max == 0);
+    }
+
+    // ---- Test 4: repairs keep skills and consecutive days when the rules select them ----
+    {
+        InputModel m;
+        for (const char* id : {"skilled", "plain"}) {
+            Staff s;
+            s.id = id;
+            s.role = "RN";
+            s.max_weekly_hours = 96;
+            s.max_consecutive_days = 1;
+            m.staff.push_back(s);
+        }
+        m.staff[0].skills = {"icu"};
+        Shifts sh;
+        sh.id = "icu_1";
+        sh.name = "ICU";
+        sh.req_role = "RN";
+        sh.req_skills = {"icu"};
+        sh.required_count = 1;
+        sh.start = make_time(2025, 4, 1, 7, 0);
+        sh.end   = make_time(2025, 4, 1, 19, 0);
+        m.shifts.push_back(sh);
+        index_shifts(m);
+        m.rules.hard_constraints = {"coverage", "skills"};
+
+        const ScheduleResult r = build_schedule(m);
+        assert(r.staff_count(0) == 1 && r.staff_begin(0)[0] == 0);
+        SimulationOptions opt;
+        opt.samples = 200;
+        opt.callout_rate = 0.5;
+        const SimulationReport gated = simulate_callouts(m, r, opt);
+        assert(gated.vacated_slots.max == 1 && gated.repaired_slots.max == 0);
+        assert(gated.uncovered_slots.mean == gated.vacated_slots.mean);
+
+        // Without the skills rule the plain RN covers (unless out too)
+        m.rules.hard_constraints = {"role"};
+        const SimulationReport open = simulate_callouts(m, r, opt);
+        assert(open.repaired_slots.max == 1);
+
+        // The plain RN works the days either side (the skilled one can't), so taking the
+        // ICU shift too breaks a one-day limit unless both of those were called out
+        for (int d : {-1, 1}) {
+            Shifts ward = sh;
+            ward.id = "ward" + std::to_string(d);
+            ward.name = "Ward";
+            ward.req_skills.clear();
+            ward.start = sh.start + Hours(24 * d);
+            ward.end   = sh.end + Hours(24 * d);
+            m.shifts.push_back(ward);
+        }
+        index_shifts(m);
+        m.staff[0].availability = {{DateStamp{2025, 3, 31}, false}, {DateStamp{2025, 4, 2}, false}};
+        const ScheduleResult around = build_schedule(m);
+        for (size_t k = 0; k < around.shift_count(); ++k) {
+            assert(around.staff_count(k) == 1 && around.staff_begin(k)[0] == (k == 1 ? 0u : 1u));
+        }
+        const SimulationReport loose = simulate_callouts(m, around, opt);
+        m.rules.hard_constraints = {"role", "consecutive_days"};
+        const SimulationReport capped = simulate_callouts(m, around, opt);
+        assert(loose.vacated_slots.mean == capped.vacated_slots.mean);
+        assert(capped.repaired_slots.mean < loose.repaired_slots.mean);
+        assert(capped.repaired_slots.max <= 1);
+    }
+
+    std::cout << "simulation_tests: all tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "../src/model.hpp"
+#include "../src/civil_time.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+
+// Reference conversion straight through the timezone database
+static std::time_t reference_mktime(int y, int m, int d, int H, int M) {
+    std::tm tm{};
+    tm.tm_year = y - 1900;
+    tm.tm_mon  = m - 1;
+    tm.tm_mday = d;
+    tm.tm_hour = H;
+    tm.tm_min  = M;
+    tm.tm_isdst = -1;
+    return std::mktime(&tm);
+}
+
+// True if local H:M on y-m-d does not exist or exists twice (DST gap/overlap)
+static bool is_ambiguous(int y, int m, int d, int H, int M) {
+    std::time_t t = reference_mktime(y, m, d, H, M);
+    std::tm* lt = std::localtime(&t);
+    if (lt->tm_hour != H || lt->tm_min != M) return true; // gap
+    std::time_t earlier = t - 3600, later = t + 3600;
+    std::tm a = *std::localtime(&earlier);
+    std::tm b = *std::localtime(&later);
+    return (a.tm_hour == H && a.tm_min == M) || (b.tm_hour == H && b.tm_min == M); // overlap
+}
+
+int main() {
+    // ---- Test 1: calendar math round-trips over +-200 years ----
+    {
+        for (int z = days_from_civil(1800, 1, 1); z <= days_from_civil(2200, 12, 31); ++z) {
+            CivilDate c = civil_from_days(z);
+            assert(days_from_civil(c.y, c.m, c.d) == z);
+            assert(c.d >= 1 && c.d <= days_in_month(c.y, c.m));
+        }
+        static_assert(days_from_civil(2024, 2, 29) + 1 == days_from_civil(2024, 3, 1));
+        static_assert(days_from_civil(2023, 2, 29) == days_from_civil(2023, 3, 1)); // rolls over like mktime
+    }
+
+    // ---- Test 2: fixed-width parsers ----
+    {
+        DateStamp ds;
+        assert(parse_date("2025-04-01", ds) && ds.y == 2025 && ds.m == 4 && ds.d == 1);
+        assert(!parse_date("2025-4-01", ds));
+        assert(!parse_date("2025-04-0x", ds));
+        assert(!parse_date("2025-13-01", ds));
+        assert(!parse_date("2025-00-10", ds));
+
+        DateTimeStamp dt;
+        assert(parse_datetime("2025-04-01T07:30", dt));
+        assert(dt.y == 2025 && dt.m == 4 && dt.d == 1 && dt.H == 7 && dt.M == 30);
+        assert(!parse_datetime("2025-04-01 07:30", dt));
+        assert(!parse_datetime("2025-04-01T7:300", dt));
+        assert(!parse_datetime("2025-04-01T07:3a", dt));
+        assert(!parse_datetime("+025-04-01T07:30", dt));
+    }
+
+    // ---- Test 3: cached conversion matches mktime hourly over 2023-2027 ----
+    {
+        const char* zones[] = {"UTC", "America/New_York", "Europe/Berlin", "Australia/Sydney", "Asia/Kolkata"};
+        for (const char* zone : zones) {
+            setenv("TZ", zone, 1);
+            tzset();
+            clear_utc_offset_cache();
+
+            int checked = 0;
+            for (int z = days_from_civil(2023, 1, 1); z <= days_from_civil(2027, 12, 31); ++z) {
+                CivilDate c = civil_from_days(z);
+                for (int H = 0; H < 24; ++H) {
+                    for (int M : {0, 30}) {
+                        if (is_ambiguous(c.y, c.m, c.d, H, M)) continue;
+                        DateTimeStamp dt{c.y, c.m, c.d, H, M};
+                        assert(Clock::to_time_t(to_time_point(dt)) == reference_mktime(c.y, c.m, c.d, H, M));
+                        ++checked;
+                    }
+                }
+            }
+            assert(checked > 80000);
+        }
+        unsetenv("TZ");
+        tzset();
+        clear_utc_offset_cache();
+    }
+
+    // ---- Test 4: hours past midnight normalize into the next day ----
+    {
+        DateTimeStamp late{2025, 4, 1, 24, 0};
+        DateTimeStamp next{2025, 4, 2, 0, 0};
+        assert(to_time_point(late) == to_time_point(next));
+    }
+
+    std::cout << "time_tests: all tests passed.\n";
+    return 0;
+}
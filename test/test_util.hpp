@@ -0,0 +1,33 @@
+#pragma once
+#include "../src/model.hpp"
+#include <string>
+
+// Builders shared by the tests
+
+// Helper to build a time point easily
+inline SysTime make_time(int year, int month, int day, int hour, int minute) {
+    DateTimeStamp dt{year, month, day, hour, minute};
+    return to_time_point(dt);
+}
+
+// Staff member with a 40 h cap and 12 h rest
+inline Staff make_staff(const std::string& id, const std::string& role) {
+    Staff s;
+    s.id = id;
+    s.role = role;
+    s.max_weekly_hours = 40;
+    s.min_rest = 12;
+    return s;
+}
+
+// ICU shift starting at start_h on 2025-04-<day>, `hours` long
+inline Shifts make_shift(const std::string& id, const std::string& role, int day, int start_h, int hours, int count) {
+    Shifts sh;
+    sh.id = id;
+    sh.name = "ICU";
+    sh.req_role = role;
+    sh.required_count = static_cast<short>(count);
+    sh.start = make_time(2025, 4, day, start_h, 0);
+    sh.end   = sh.start + Hours(hours);
+    return sh;
+}
@@ -0,0 +1,145 @@
+#include "../src/model.hpp"
+#include "../src/engine.hpp"
+#include "../src/csv_writer.hpp"
+#include "../src/validate.hpp"
+#include "test_util.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+int main() {
+    // ---- Test 1: the engine's own schedules read back unchanged and pass ----
+    {
+        for (unsigned seed = 1; seed <= 10; ++seed) {
+            unsigned state = seed;
+            auto next = [&](unsigned mod) { state = state * 1103515245u + 12345u; return (state >> 16) % mod; };
+            const char* roles[] = {"RN", "LPN"};
+            InputModel m;
+            for (int i = 0; i < 150; ++i) {
+                Staff s = make_staff("s" + std::to_string(i), roles[next(2)]);
+                s.max_weekly_hours = static_cast<short>(8 + next(40));
+                s.min_rest = static_cast<short>(next(13));
+                s.max_consecutive_days = static_cast<short>(1 + next(4));
+                if (next(3) == 0) s.skills = {"vent"};
+                if (next(2) == 0) s.prefs.avoid_nights = true;
+                for (int d = 1; d <= 14; ++d) {
+                    if (next(5) == 0) s.availability.push_back({DateStamp{2025, 4, d}, false});
+                }
+                m.staff.push_back(s);
+            }
+            for (int i = 0; i < 300; ++i) {
+                Shifts sh = make_shift("x" + std::to_string(i), roles[next(2)], 1 + static_cast<int>(next(14)),
+                                       static_cast<int>(next(24)), 4 + static_cast<int>(next(9)), static_cast<int>(next(4)));
+                if (next(4) == 0) sh.req_skills = {"vent"};
+                m.shifts.push_back(sh);
+            }
+            index_shifts(m);
+            m.rules.hard_constraints = {"coverage", "legal_limits", "consecutive_days", "skills"};
+
+            const ScheduleResult r = build_schedule(m);
+            std::stringstream csv;
+            write_schedule_csv(m, r, csv);
+            std::vector<Violation> problems;
+            const ScheduleResult back = read_schedule_csv(m, csv, problems);
+            assert(problems.empty());
+            assert(back.shift_index == r.shift_index && back.staff_offsets == r.staff_offsets);
+            for (size_t k = 0; k < r.shift_count(); ++k) {
+                std::vector<std::uint32_t> a(r.staff_begin(k), r.staff_end(k)), b(back.staff_begin(k), back.staff_end(k));
+                std::sort(a.begin(), a.end());
+                std::sort(b.begin(), b.end());
+                assert(a == b);
+            }
+            for (size_t w = 0; w < m.staff.size(); ++w) {
+                assert(back.staff_totals[w].minutes == r.staff_totals[w].minutes);
+                assert(back.staff_totals[w].nights == r.staff_totals[w].nights);
+                assert(back.staff_totals[w].preference_violations == r.staff_totals[w].preference_violations);
+            }
+            for (unsigned threads : {1u, 3u}) {
+                const ValidationReport rep = validate_schedule(m, back, threads);
+                assert(rep.violations.empty() && rep.assignments == r.staff_index.size());
+            }
+        }
+    }
+
+    // ---- Test 2: a hand-edited schedule with one of each problem ----
+    {
+        InputModel m;
+        m.staff = {make_staff("a", "RN"), make_staff("b", "LPN")};
+        m.staff[0].max_weekly_hours = 16;
+        m.staff[0].max_consecutive_days = 2;
+        m.staff[0].min_rest = 9;
+        m.staff[0].availability.push_back({DateStamp{2025, 4, 3}, false});
+        m.shifts = {make_shift("s1", "RN", 1, 7, 8, 1), make_shift("s2", "RN", 1, 19, 4, 1),
+                    make_shift("s3", "RN", 2, 9, 8, 1), make_shift("s4", "RN", 3, 7, 8, 1),
+                    make_shift("s5", "RN", 4, 7, 8, 2)};
+        m.shifts[4].req_skills = {"vent"};
+        index_shifts(m);
+        m.rules.hard_constraints = {"coverage", "legal_limits", "consecutive_days", "skills"};
+
+        std::stringstream csv;
+        csv << "shift_id,unit,start,end,required_role,required_count,assigned_count,assigned_staff_ids,coverage_ok,missing_count\n"
+            << "s1,ICU,,,RN,1,1,a,Yes,0\n"
+            << "s2,ICU,,,RN,1,1,a,Yes,0\n"
+            << "s3,ICU,,,RN,1,1,a,Yes,0\n"
+            << "s4,ICU,,,RN,1,1,a,Yes,0\n"
+            << "nope,ICU,,,RN,1,1,a,Yes,0\n"
+            << "s1,ICU,,,RN,1,0,,No,1\n"
+            << "s5,ICU,,,RN,2,3,b;zz;b,Yes,0\n";
+        std::vector<Violation> problems;
+        const ScheduleResult s = read_schedule_csv(m, csv, problems);
+        assert(problems.size() == 4);
+        assert(problems[0].kind == ViolationKind::UnknownShift && problems[0].shift_id == "nope");
+        assert(problems[1].kind == ViolationKind::DuplicateShift && problems[1].shift_id == "s1");
+        assert(problems[2].kind == ViolationKind::UnknownStaff && problems[2].staff_id == "zz");
+        assert(problems[3].kind == ViolationKind::DuplicateStaff && problems[3].staff_id == "b");
+        assert(s.staff_count(0) == 1 && s.staff_count(4) == 1);
+        assert(s.staff_totals[0].minutes == 28 * 60 && s.staff_totals[1].shifts == 1);
+
+        const ValidationReport rep = validate_schedule(m, s);
+        const std::vector<std::pair<ViolationKind, std::string>> expected = {
+            {ViolationKind::Rest, "s2"},         {ViolationKind::WeeklyHours, "s3"},
+            {ViolationKind::Availability, "s4"}, {ViolationKind::ConsecutiveDays, "s4"},
+            {ViolationKind::Role, "s5"},         {ViolationKind::Skills, "s5"},
+        };
+        assert(rep.violations.size() == expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            assert(rep.violations[i].kind == expected[i].first && rep.violations[i].shift_id == expected[i].second);
+            assert(rep.violations[i].detail.find(',') == std::string::npos);
+        }
+        assert(rep.violations[0].staff_id == "a" && rep.violations[4].staff_id == "b");
+
+        // Only what the rules select (role and availability always)
+        m.rules.hard_constraints = {"role", "availability"};
+        const ValidationReport loose = validate_schedule(m, s);
+        assert(loose.violations.size() == 2);
+        assert(loose.violations[0].kind == ViolationKind::Availability && loose.violations[1].kind == ViolationKind::Role);
+    }
+
+    // ---- Test 3: a CSV without the expected header is rejected, not read by position ----
+    {
+        InputModel m;
+        m.staff = {make_staff("a", "RN")};
+        m.shifts = {make_shift("s1", "RN", 1, 7, 8, 1)};
+        index_shifts(m);
+        for (const char* text : {"s1,a\n", "shift_id,staff\ns1,a\n", "id,assigned_staff_ids\ns1,a\n", ""}) {
+            std::stringstream csv(text);
+            std::vector<Violation> problems;
+            bool threw = false;
+            try {
+                read_schedule_csv(m, csv, problems);
+            } catch (const std::runtime_error&) {
+                threw = true;
+            }
+            assert(threw);
+        }
+        std::stringstream csv("assigned_staff_ids,shift_id\na,s1\n");
+        std::vector<Violation> problems;
+        const ScheduleResult s = read_schedule_csv(m, csv, problems);
+        assert(problems.empty() && s.staff_count(0) == 1);
+    }
+
+    std::cout << "validate_tests: all tests passed.\n";
+    return 0;
+}